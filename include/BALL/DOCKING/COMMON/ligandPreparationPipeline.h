@@ -0,0 +1,247 @@
+// -*- Mode: C++; tab-width: 2; -*-
+// vi: set ts=2:
+//
+
+#ifndef BALL_DOCKING_COMMON_LIGANDPREPARATIONPIPELINE_H
+#define BALL_DOCKING_COMMON_LIGANDPREPARATIONPIPELINE_H
+
+#ifndef BALL_DATATYPE_OPTIONS_H
+# include <BALL/DATATYPE/options.h>
+#endif
+
+#include <vector>
+#include <iostream>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace BALL
+{
+	class Atom;
+	class Molecule;
+	class GenericMolFile;
+
+	/** Batch preparation of ligands.
+	 		\ingroup DockingCommon
+
+			Streams the molecules of a file through the usual preparation steps and
+			writes the result to another file (usually SD or MOL2):
+
+			- <b>BUILD_BONDS</b>: molecules without any bond get their bonds from the
+			  BuildBondsProcessor.
+			- <b>RING_PERCEPTION</b>: the SSSR and all small rings are perceived once per molecule.
+			- <b>ASSIGN_BOND_ORDERS</b>: molecules that do not contain a single multiple or aromatic
+			  bond are handed to the AssignBondOrderProcessor.
+			- <b>ADD_HYDROGENS</b>: missing hydrogens are added by the AddHydrogenProcessor,
+			  using the small rings perceived before.
+			- <b>AROMATICITY</b>: aromatic rings are marked by the AromaticityProcessor on the SSSR;
+			  the Kekule bond orders are kept.
+			- <b>ATOM_TYPES</b>: MMFF94 atom types and charges, or GAFF atom types (stored in
+			  the property "atomtype"). GAFF typing reuses the SSSR and the aromaticity of the
+			  previous stages. MMFF94 is set up on a copy of the molecule, whose atom types,
+			  type names and charges are then transferred, so the molecule stays in its system.
+
+			Adding hydrogens does not change the ring systems, so the rings perceived
+			once are handed to the AddHydrogenProcessor, the AromaticityProcessor and
+			the GAFFTypeProcessor. The AssignBondOrderProcessor and MMFF94 still perceive
+			the rings they need on their own. The MMFF94 setup of different workers is
+			serialized, since it is not thread safe.
+
+			Molecules for which a stage fails are counted as failures, but are written
+			nevertheless.
+
+			Molecules are read and written by the calling thread in blocks of
+			Option::BLOCK_SIZE. Inside a block, a pool of Option::NUMBER_OF_THREADS
+			workers takes one molecule at a time and runs all stages on it. Every worker
+			owns its own set of processors, so parameter files are read only once per worker.
+			The wall clock time spent in every stage is summed over all workers.
+
+			\code
+				LigandPreparationPipeline pipeline;
+				pipeline.options.set(LigandPreparationPipeline::Option::ATOM_TYPES,
+				                     LigandPreparationPipeline::AtomTypes::GAFF);
+				pipeline.run("ligands.mol2", "prepared.sdf");
+				pipeline.printTimings(std::cout);
+			\endcode
+	*/
+	class BALL_EXPORT LigandPreparationPipeline
+	{
+		public:
+
+			/** @name Constant Definitions
+			*/
+			//@{
+			/// Option names
+			struct BALL_EXPORT Option
+			{
+				/** Build the bonds of molecules without bonds.
+				 */
+				static const char* BUILD_BONDS;
+
+				/** Assign the bond orders of molecules without multiple bonds.
+				 */
+				static const char* ASSIGN_BOND_ORDERS;
+
+				/** Add missing hydrogens.
+				 */
+				static const char* ADD_HYDROGENS;
+
+				/** Mark aromatic rings.
+				 */
+				static const char* AROMATICITY;
+
+				/** The atom types to assign, see AtomTypes.
+				 */
+				static const char* ATOM_TYPES;
+
+				/** Number of molecules read before they are processed.
+				 */
+				static const char* BLOCK_SIZE;
+
+				/** Number of worker threads. 0 means one per processor core.
+				 */
+				static const char* NUMBER_OF_THREADS;
+			};
+
+			/// Default values for options
+			struct BALL_EXPORT Default
+			{
+				static const bool        BUILD_BONDS;
+				static const bool        ASSIGN_BOND_ORDERS;
+				static const bool        ADD_HYDROGENS;
+				static const bool        AROMATICITY;
+				static const String      ATOM_TYPES;
+				static const Size        BLOCK_SIZE;
+				static const Size        NUMBER_OF_THREADS;
+			};
+
+			/// Values of Option::ATOM_TYPES
+			struct BALL_EXPORT AtomTypes
+			{
+				/// keep the atom types of the input
+				static const String NONE;
+
+				/// MMFF94 atom types and partial charges
+				static const String MMFF94;
+
+				/// GAFF atom types
+				static const String GAFF;
+			};
+
+			/// The stages of the pipeline
+			enum Stage
+			{
+				READ = 0,
+				BUILD_BONDS,
+				RING_PERCEPTION,
+				ASSIGN_BOND_ORDERS,
+				ADD_HYDROGENS,
+				AROMATICITY,
+				ATOM_TYPES,
+				WRITE,
+				NUMBER_OF_STAGES
+			};
+			//@}
+
+			/** @name	Constructors and Destructors
+			*/
+			//@{
+
+			/// Default constructor
+			LigandPreparationPipeline();
+
+			/// Copy constructor. Only the options are copied.
+			LigandPreparationPipeline(const LigandPreparationPipeline& pipeline);
+
+			/// Destructor
+			virtual ~LigandPreparationPipeline();
+
+			/// Assignment operator. Only the options are copied.
+			LigandPreparationPipeline& operator = (const LigandPreparationPipeline& pipeline);
+
+			/// Resets the statistics and releases the workers. The options remain.
+			void clear();
+			//@}
+
+			/**	@name	Processing
+			*/
+			//@{
+
+			/// Resets the options to default values.
+			void setDefaultOptions();
+
+			/** Prepare all molecules of input and write them to output.
+			 *  @return the number of molecules written
+			 */
+			Size run(GenericMolFile& input, GenericMolFile& output);
+
+			/** Prepare all molecules of the file input and write them to the file output.
+			 *  Both files are opened by the MolFileFactory, so the formats are determined by the extensions.
+			 *  @return the number of molecules written
+			 *  @throw Exception::FileNotFound if input cannot be opened
+			 */
+			Size run(const String& input, const String& output);
+
+			/** Run all stages on a single molecule in the calling thread.
+			 *  @return false if one of the stages failed
+			 */
+			bool prepare(Molecule& molecule);
+			//@}
+
+			/**	@name	Statistics
+			*/
+			//@{
+
+			/// Return the number of molecules processed since the last clear()
+			Size getNumberOfMolecules() const { return number_of_molecules_; }
+
+			/// Return the number of molecules for which one of the stages failed
+			Size getNumberOfFailures() const { return number_of_failures_; }
+
+			/// Return the time spent in the given stage (in seconds, summed over all workers)
+			double getStageTime(Stage stage) const { return stage_times_[stage]; }
+
+			/// Return the name of a stage
+			static const char* getStageName(Stage stage);
+
+			/// Print the time spent in every stage
+			void printTimings(std::ostream& out) const;
+			//@}
+
+			/** @name Public Attributes
+			*/
+			//@{
+			/// options
+			Options options;
+			//@}
+
+		protected:
+
+			class Worker_;
+
+			/// Create the workers if the options changed or no workers exist yet
+			void setupWorkers_(Size number_of_workers);
+
+			/// Body of a worker thread: process molecules of the current block until none are left
+			void workerThread_(Position worker);
+
+			/// Add the statistics of a worker
+			void collect_(const Worker_& worker);
+
+			std::vector<boost::shared_ptr<Worker_> > workers_;
+			// the options the workers were created with
+			Options                                  worker_options_;
+
+			// the block currently processed
+			std::vector<Molecule*>                   block_;
+			Position                                 next_molecule_;
+			boost::mutex                             block_mutex_;
+
+			std::vector<double>                      stage_times_;
+			Size                                     number_of_molecules_;
+			Size                                     number_of_failures_;
+	};
+
+} // namespace BALL
+
+#endif // BALL_DOCKING_COMMON_LIGANDPREPARATIONPIPELINE_H
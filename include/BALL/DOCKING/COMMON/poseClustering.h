@@ -48,7 +48,9 @@
 
 #ifdef BALL_HAS_TBB
 # include <tbb/parallel_reduce.h>
+# include <tbb/parallel_for.h>
 # include <tbb/blocked_range.h>
+# include <tbb/blocked_range2d.h>
 #endif
 
 //#define POSECLUSTERING_DEBUG 1
@@ -56,6 +58,9 @@
 
 namespace BALL
 {
+	class TrajectoryFile;
+	class GenericMolFile;
+
 	/** Pose Clustering 
 	    \ingroup DockingMiscellaneous
 	 */
@@ -111,6 +116,25 @@ namespace BALL
 
 			By setting the option RUN_PARALLEL to true, the user can request parallel execution. This will be performed
 			if the execution environment is enabled (BALL_HAS_TBB), and if the algorithm supports it.
+
+			If the option PRECOMPUTE_POSE_COORDINATES is set (default), the pairwise distances required by
+			TRIVIAL_COMPLETE_LINKAGE, SLINK_SIBSON, and CLINK_DEFAYS are computed from a contiguous float matrix
+			holding one column per pose, in cache-sized tiles that are distributed over all threads if RUN_PARALLEL
+			is set. Each column contains the atom coordinates of the selected atoms (SNAPSHOT_RMSD), the center of
+			mass (CENTER_OF_MASS_DISTANCE), or the translation and the rotation multiplied with a square root of the
+			covariance matrix (RIGID_RMSD), so that all distances reduce to Euclidean distances between columns.
+
+			Pose sets that are too large to be held in memory can be clustered with computeStreaming(). The poses
+			are read one by one from a trajectory or a molecular file (e.g. a DockResultFile), reduced to the
+			column described above, and immediately inserted into the pointer representation of SLINK_SIBSON or
+			CLINK_DEFAYS. Only the columns and the O(n) arrays of the pointer representation are kept, so that
+			RIGID_RMSD requires 12 floats and CENTER_OF_MASS_DISTANCE 3 floats per pose. SNAPSHOT_RMSD, however,
+			keeps the coordinates of all selected atoms, i.e. 3 floats per selected atom and pose, since the
+			distances of each new snapshot to all previous ones are needed: its memory footprint grows with
+			O(n * number of selected atoms). For long trajectories of large systems, a coarser RMSD_LEVEL_OF_DETAIL
+			(e.g. C_ALPHA or BACKBONE) keeps this footprint small. Since the poses
+			themselves are not kept, methods that need them report an error after a streamed clustering
+			(see isStreamed()).
 	*/
 
   class BALL_EXPORT PoseClustering
@@ -142,6 +166,10 @@ namespace BALL
 				 */
 				static const String RUN_PARALLEL;
 
+				/** flag for computing pairwise distances from a precomputed coordinate matrix
+				 */
+				static const String PRECOMPUTE_POSE_COORDINATES;
+
 			};
 
 			/// Default values for options
@@ -152,6 +180,7 @@ namespace BALL
 				static const Index RMSD_LEVEL_OF_DETAIL;
 				static const Index RMSD_TYPE;
 				static const bool  RUN_PARALLEL;
+				static const bool  PRECOMPUTE_POSE_COORDINATES;
 				static const bool USE_CENTER_OF_MASS_PRECLINK;
 			};
 
@@ -296,6 +325,30 @@ namespace BALL
 			*/
 			bool compute();
 
+			/** Cluster all snapshots of the given trajectory without keeping them in memory.
+			 *  The snapshots have to refer to the given base system. Only the methods 
+			 *  SLINK_SIBSON and CLINK_DEFAYS are supported. 
+			 *  The clusters contain the indices of the snapshots in the trajectory.
+			 *  For SNAPSHOT_RMSD, the coordinates of the selected atoms of every snapshot are kept
+			 *  (3 floats per selected atom and snapshot), see the class description.
+			 */
+			bool computeStreaming(System const& base_system, TrajectoryFile& trajectory);
+
+			/** Cluster all molecules of the given file without keeping them in memory.
+			 *  Each molecule has to contain the atoms of the given base system in the same order.
+			 *  Only the methods SLINK_SIBSON and CLINK_DEFAYS are supported.
+			 *  The clusters contain the indices of the molecules in the file.
+			 */
+			bool computeStreaming(System const& base_system, GenericMolFile& file);
+
+			/** Returns true if the current clustering has been computed by computeStreaming().
+			 *  The poses of a streamed clustering are not stored: only the cluster indices and scores
+			 *  are available, and all methods that need the poses themselves (e.g.
+			 *  getClusterConformationSet(), getReducedConformationSet(), refineClustering())
+			 *  report an error instead.
+			 */
+			bool isStreamed() const {return num_streamed_poses_ > 0;}
+
 			//@}
 
 			/**	@name	Access methods
@@ -543,6 +596,51 @@ namespace BALL
 					// the minimum value in our own block
 					float my_min_value_;
 			};
+
+			/** A nested class used for the parallel computation of all pairwise distances.
+			 */
+			class ComputePairwiseScoresTask_
+			{
+				public:
+					ComputePairwiseScoresTask_(PoseClustering const* parent, Eigen::MatrixXd& scores)
+						: parent_(parent),
+						  scores_(scores)
+					{ }
+
+					void operator() (const tbb::blocked_range2d<size_t>& r) const
+					{
+						parent_->computeDistanceTile_(r.rows().begin(), r.rows().end(), r.cols().begin(), r.cols().end(), scores_);
+					}
+
+				protected:
+					PoseClustering const* parent_;
+
+					Eigen::MatrixXd& scores_;
+			};
+
+			/** A nested class used for the parallel computation of the distances of one pose to a range of poses.
+			 */
+			class ComputeDistanceRowTask_
+			{
+				public:
+					ComputeDistanceRowTask_(PoseClustering const* parent, Position pose, std::vector<double>& result)
+						: parent_(parent),
+						  pose_(pose),
+						  result_(result)
+					{ }
+
+					void operator() (const tbb::blocked_range<size_t>& r) const
+					{
+						parent_->computeDistanceRow_(pose_, r.begin(), r.end(), result_);
+					}
+
+				protected:
+					PoseClustering const* parent_;
+
+					Position pose_;
+
+					std::vector<double>& result_;
+			};
 #endif
 
 			/** A nested class used for exporting cluster trees to graphviz format
@@ -588,6 +686,21 @@ namespace BALL
 			// space efficient (SLINK or CLINK) clustering
 			bool linearSpaceCompute_();
 
+			// convert the pointer representation computed by SLINK or CLINK to clusters
+			void extractLinearSpaceClusters_(Size num_poses);
+
+			// prepare the data structures for clustering a stream of poses of the given system
+			bool startStreaming_(System const& base_system);
+
+			// add the pose given by the positions of all atoms of the base system to a streaming clustering
+			bool addStreamedPose_(std::vector<Vector3> const& positions);
+
+			// convert the pointer representation of a streaming clustering to clusters
+			bool finishStreaming_();
+
+			// returns false and reports an error if the poses are not available because of a streamed clustering
+			bool checkStoredPoses_(String const& method) const;
+
 			//
 			bool althausCompute_();
 
@@ -636,6 +749,34 @@ namespace BALL
 			// compute the RMSD between two "poses"  
 			float getRMSD_(Index i, Index j, Index rmsd_type);
 
+			// compute the indices (wrt. the atom iterator) of the atoms selected by the atom bijection;
+			// returns false if the bijection does not map each atom of system_i_ onto its copy in system_j_
+			bool computeSelectedAtomIndices_(std::vector<Position>& selected_atoms);
+
+			// compute L with L L^t = covariance_matrix_
+			Eigen::Matrix3f computeCovarianceRoot_() const;
+
+			// fill pose_coordinates_ with one column per pose, such that the distance
+			// of type rmsd_type between two poses is the scaled Euclidean distance of
+			// their columns; returns false if this is not possible for the current input
+			bool precomputePoseCoordinates_(Index rmsd_type);
+
+			// compute the distances between all pairs of poses in the given tile of
+			// pose indices; only pairs (i, j) with i < j are computed, and stored symmetrically
+			void computeDistanceTile_(Size row_begin, Size row_end, Size col_begin, Size col_end, Eigen::MatrixXd& scores) const;
+
+			// compute the distances between pose i and all poses in [begin, end)
+			void computeDistanceRow_(Position i, Size begin, Size end, std::vector<double>& result) const;
+
+			// compute all pairwise distances from pose_coordinates_ and store them in pairwise_scores_
+			void computePairwiseScores_();
+
+			// compute the distances between pose i and all poses with smaller index from pose_coordinates_
+			void computeDistancesToPredecessors_(Position i, std::vector<double>& result);
+
+			// the number of poses per tile used by the distance computations
+			Size getDistanceTileSize_() const;
+
 			// store pointers to the snapshots in the poses vector
 			void storeSnapShotReferences_();
 
@@ -700,6 +841,29 @@ namespace BALL
 
 			std::vector<double>    mu_;
 
+			// ----- data structures for the distance computations
+
+			// one column per pose, see precomputePoseCoordinates_
+			Eigen::MatrixXf        pose_coordinates_;
+
+			// the squared distance between two columns of pose_coordinates_ 
+			// has to be multiplied by this factor to obtain the squared rmsd
+			float                  pose_coordinate_scale_;
+
+			// ----- data structures for streaming clustering
+
+			// the number of poses read so far
+			Size                   num_streamed_poses_;
+
+			// the indices of the atoms selected by the atom bijection
+			std::vector<Position>  streamed_atom_indices_;
+
+			// see computeCovarianceRoot_
+			Eigen::Matrix3f        covariance_root_;
+
+			// the center of the first pose of the stream
+			Vector3                first_streamed_center_;
+
 
 			// ----- data structures for nearest neighbor chain ward
 			Size                   number_of_selected_atoms_;
@@ -21,6 +21,10 @@
 #include <BALL/SCORING/COMMON/scoringFunction.h>
 #endif
 
+#ifndef BALL_SCORING_COMMON_DIFFGRIDBASEDSCORING_H
+#include <BALL/SCORING/COMMON/diffGridBasedScoring.h>
+#endif
+
 #ifndef BALL_DOCKING_COMMON_STATICLIGANDFRAGMENT_H
 #include <BALL/DOCKING/COMMON/staticLigandFragment.h>
 #endif
@@ -64,6 +68,7 @@ namespace BALL
 				static const char* ITERATIONS;
 				static const char* DECREASE_STEPWIDTH;
 				static const char* SUPERPOSE_LIGAND;
+				static const char* BRANCH_AND_BOUND;
 			};
 
 			struct Default
@@ -78,6 +83,7 @@ namespace BALL
 				static int ITERATIONS;
 				static bool DECREASE_STEPWIDTH;
 				static bool SUPERPOSE_LIGAND;
+				static bool BRANCH_AND_BOUND;
 			};
 
 			/**	@name	Accessors  */
@@ -116,6 +122,9 @@ namespace BALL
 
 			const AtomContainer* getLigand();
 
+			/** returns the number of poses that were not expanded during the last call of startDock() because of option BRANCH_AND_BOUND */
+			Size getNumberOfPrunedPoses() const;
+
 			//ConformationSet getConformationSet(Index total_conformations);
 
 			/** stores the default options of this algorithms in the given Option object */
@@ -165,6 +174,17 @@ namespace BALL
 
 			void applyConformation(const std::vector < int > & conf, bool verbose = 0);
 
+			/** checks whether the expansion of the given pose at the given bond can still yield a pose that enters the list of best conformations.\n
+			The bound for the score of all children keeps the grid contributions of the atoms that are not moved by the rotation and uses the lowest grid values for all other atoms (see DiffGridBasedScoring::calculateScoreLowerBound()).
+			Since it is a true lower bound, pruning does not change the result of the search. */
+			bool canImprove(const std::vector < int > & parent, Size bond, const PoseList& best_conformations) const;
+
+			/** prepares the lower bounds used by canImprove() for the current ligand; pruning is disabled if the ScoringFunction cannot bound its score */
+			void setupBranchAndBound();
+
+			/** marks all atoms that are moved by rotateLigandFragment(lf, M, origin, static_fragment) as not fixed */
+			void markMovedAtoms(StaticLigandFragment* lf, int static_fragment, const std::map < const Atom* , Position > & atom_index, std::vector < bool > & fixed_atoms) const;
+
 			/** try to find a bond, so that the force vector is orthogonal to the plane spanned by the bond and the fragment center */
 			//void findBestFragmentRotation(int fragment, Size& bond, int& degree, map<int>* ignore_bonds);
 
@@ -246,6 +266,23 @@ namespace BALL
 
 			SideChainOptimizer* sidechain_optimizer_;
 
+			/** if set to true (via options), poses whose lower bound cannot enter the current k-best are not expanded (see canImprove()). \n
+			Scores are still computed for the entire ligand: since the burial scaling, the constraints and the backtransformation of the score are not decomposable per fragment,
+			neither per-fragment score tables nor incremental scoring are used. */
+			bool branch_and_bound_;
+
+			/** the ScoringFunction used for calculating lower bounds, or NULL if the score cannot be bounded */
+			DiffGridBasedScoring* bounded_scoring_;
+
+			/** the grid contributions of the atoms of each pose that can still be expanded */
+			std::map < std::vector < int > , std::vector < double > > pose_atom_scores_;
+
+			/** for each entry of current_conformation_, the ligand atoms that are not moved by rotations around this bond */
+			std::vector < std::vector < bool > > fixed_atoms_;
+
+			/** the number of poses that were not expanded during the last call of startDock() */
+			Size pruned_branches_;
+
 			//@}
 	};
 }
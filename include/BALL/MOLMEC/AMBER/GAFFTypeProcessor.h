@@ -29,6 +29,14 @@
 # include <BALL/KERNEL/molecule.h>
 #endif
 
+#ifndef BALL_DATATYPE_HASHMAP_H
+# include <BALL/DATATYPE/hashMap.h>
+#endif
+
+#ifndef BALL_DATATYPE_STRINGHASHMAP_H
+# include <BALL/DATATYPE/stringHashMap.h>
+#endif
+
 #include <vector>
 #include <map>
 
@@ -56,6 +64,12 @@ namespace BALL
 
 				/// switch cleanup of GAFF types (cc=>cd, ...) on or off
 				static const String GAFF_ATOMTYPE_POSTPROCESSING;
+
+				/// remember the type assigned to each chemical environment, see clearEnvironmentCache()
+				static const String USE_ENVIRONMENT_CACHE;
+
+				/// the number of chemical environments after which the cache is cleared
+				static const String ENVIRONMENT_CACHE_SIZE;
 			};
 
 			struct BALL_EXPORT Default
@@ -65,6 +79,12 @@ namespace BALL
 
 				/// switch cleanup of GAFF types (cc=>cd, ...) on or off
 				static const bool GAFF_ATOMTYPE_POSTPROCESSING;
+
+				/// remember the type assigned to each chemical environment (on)
+				static const bool USE_ENVIRONMENT_CACHE;
+
+				/// the number of chemical environments after which the cache is cleared (100000)
+				static const Size ENVIRONMENT_CACHE_SIZE;
 			};
 
 			enum BALL_EXPORT BOND_TYPES
@@ -85,6 +105,27 @@ namespace BALL
 
       std::set<String> getTypeNames() const;
 
+			/** Use the given SSSR for the next molecule instead of perceiving rings and aromaticity again.
+			 *  The molecule must already have been aromatized on this SSSR by the AromaticityProcessor.
+			 */
+			void setSSSR(const std::vector<std::vector<Atom*> >& sssr);
+
+			/** Forget the atom types of all chemical environments seen so far.
+			 *  Atoms are typed by the rules of the atom type table, which only look at
+			 *  the properties of an atom and of its neighbours up to the depth of the
+			 *  deepest chemical environment string. If Option::USE_ENVIRONMENT_CACHE is
+			 *  set, these atoms and the bonds between them are collected into a graph for
+			 *  every atom, and the type found for the canonical form of the graph is reused
+			 *  for all atoms in the same environment, also in later molecules, no matter
+			 *  in which order their atoms and bonds are stored. Once the cache holds
+			 *  Option::ENVIRONMENT_CACHE_SIZE environments, it is cleared before the next
+			 *  molecule.
+			 */
+			void clearEnvironmentCache();
+
+			/// Return the number of chemical environments in the cache
+			Size getEnvironmentCacheSize() const { return environment_cache_.size(); }
+
 			Options options;
 
 		protected:
@@ -125,6 +166,32 @@ namespace BALL
 			 */
 			bool assignAtomtype_(Atom& atom);
 
+			/** A rule of the atom type table, with the numerical fields converted
+			 *  and the GAFFCESParser for its APS/CES string looked up.
+			 */
+			struct CompiledType_
+			{
+				String atom_type;
+				int connectivity;
+				// -1 if the field is "*"
+				int attached_hydrogens;
+				int electron_withdrawal_atoms;
+				GAFFCESParser* parser;
+			};
+
+			/** Build compiled_types_ and type_index_ from atom_types_ and ces_parsers_.
+			 */
+			void compileAtomTypes_();
+
+			/** Collect the properties read by the type rules for every atom of the molecule.
+			 */
+			void computeLocalEnvironments_(Molecule* molecule);
+
+			/** Append the canonical key of the environment of atom up to environment_depth_.
+			 *  Return false if no key could be computed, e.g. for very symmetric environments.
+			 */
+			bool computeEnvironmentKey_(const Atom& atom, String& key) const;
+
 			/** Postprocessing and cleanup for GAFF types
 			 */
 			void postProcessAtomTypes_(Molecule* molecule);
@@ -139,6 +206,28 @@ namespace BALL
 			// smallest set of smallest rings used for atomic environment strings
 			std::vector<std::vector<Atom*> > sssr_;
 
+			// sssr_ was set by setSSSR() for the next molecule
+			bool use_given_sssr_;
+
+			// all type rules in the order of the atom type table
+			std::vector<CompiledType_> compiled_types_;
+
+			// the rules that have to be tested for an element and a connectivity, in table order;
+			// connectivity -1 lists the rules without restriction
+			std::map<Position, std::map<int, std::vector<Position> > > type_index_;
+
+			// the depth of the deepest chemical environment string
+			Size environment_depth_;
+
+			// the id of the local properties of every atom of the current molecule
+			HashMap<const Atom*, Position> local_environment_ids_;
+
+			// ids of all local properties seen so far
+			StringHashMap<Position> local_environments_;
+
+			// the atom type assigned to every environment key
+			StringHashMap<String> environment_cache_;
+
 			///
 			Molecule* current_molecule_;
 	};
@@ -11,8 +11,16 @@
 #include <BALL/KERNEL/atomContainer.h>
 #endif
 
-#ifndef BALL_STRUCTURE_SIMPLEMOLECULARGRAPH_H
-#include <BALL/STRUCTURE/simpleMolecularGraph.h>
+#ifndef BALL_KERNEL_MOLECULE_H
+#include <BALL/KERNEL/molecule.h>
+#endif
+
+#ifndef BALL_KERNEL_BOND_H
+#include <BALL/KERNEL/bond.h>
+#endif
+
+#ifndef BALL_QSAR_RINGSET_H
+#include <BALL/QSAR/ringSet.h>
 #endif
 
 #ifndef BALL_DATATYPE_OPTIONS_H
@@ -20,7 +28,6 @@
 #endif
 
 
-#include <stack>
 #include <vector>
 
 namespace BALL
@@ -28,10 +35,11 @@ namespace BALL
 /**	Processor, which marks all atoms and bonds in a ring structure with the
 			Composite Property "InRing".
 			calculateSSSR() can also compute the number of rings found.
-			
-			The processor is an implementation of the Balducci Pearlman algorithm
-			described in:
-			Renzo Balducci, Robert S. Pearlman, J. Chem. Inf. Comput. Sci., 34:822-831, 1994
+
+			The rings are perceived by RingSet, which stores them in the AtomContainer:
+			as long as the atoms and bonds of the container do not change, repeated
+			ring perceptions (e.g. by different processors applied to the same molecule)
+			cost a single pass over the atoms and bonds.
 	*/
 class BALL_EXPORT RingPerceptionProcessor
 		:	public UnaryProcessor<AtomContainer>
@@ -76,8 +84,8 @@ public:
 	Size calculateSSSR(vector<vector<Atom*> >& sssr, AtomContainer& ac);
 	//@}
 
-	/** Getter which returns all the 3 - 6 membered rings, calculateSSSR with
-			 *  the Balducci-Pearlman Algorithm (defalt) is needed prior this call.
+	/** Getter which returns all the 3 - 6 membered rings, calculateSSSR 
+			 *  is needed prior this call.
 			 */
 	const vector<vector<Atom*> >& getAllSmallRings() const;
 
@@ -89,85 +97,8 @@ public:
 
 protected:
 
-	// Balducci and Pearlman algorithm
-	struct PathMessage_;
-
-	/*_ The tnode structure described in the paper
-			*/
-	struct TNode_
-	{
-		/// method to process the messages in the recieve buffer
-		void recieve();
-
-		/// method to process the messages in the send buffer
-		void send();
-
-		bool haveZeroIntersection(BitVector& beep1, BitVector& beep2);
-
-		bool haveSingleIntersection(BitVector& beep1, BitVector& beep2);
-
-		bool nodeIsNew(BitVector& beep, NodeItem<Index, Index>* node);
-
-		/// the recieve buffer, where messages are stored in
-		std::vector<PathMessage_> recieve_buffer;
-
-		/// the send buffer, where messages are stored in
-		std::vector<PathMessage_> send_buffer;
-	};
-
-	/*_ The pathMsg structure described in the paper
-			*/
-	struct PathMessage_
-	{
-		void push(EdgeItem<Index, Index>* bond, TNode_* node);
-		
-		// path of the message
-		BitVector beep;
-
-		/// pointer to the first node this message was sent from
-		TNode_* nfirst;
-
-		// pointer to the last node of the messages' path
-		TNode_* nlast;
-
-		/// pointer to the first edge of the message path
-		EdgeItem<Index, Index>* efirst;
-	};
-
-	/// mapping for internal TNode structure and the nodes of the molecular graph
-	static HashMap<TNode_*, NodeItem<Index, Index>* > tnode_to_atom_;
-	static HashMap<NodeItem<Index, Index>* , TNode_*> atom_to_tnode_;
-
-	/// mapping for the path representation as bitvectors
-	static HashMap<EdgeItem<Index, Index>*, Size> bond_to_index_;
-	static HashMap<Size, EdgeItem<Index, Index>*> index_to_bond_;
-
-	/// the SSSR detected by the algorithm
-	static std::vector<BitVector> rings_;
-
-	/// the matrix for the independency tests
-	static std::vector<BitVector> matrix_;
-
-	/// the rings of the ith phase, which are to be forwarded to the ring selector
-	static std::vector<BitVector> forwarded_rings_;
-
-	/// rings (beer) which have already been tested
-	static std::vector<BitVector> tested_beers_;
-
-	/// contains all 3 to 6 membered rings after the procedure of the Balducci-Pearlman algorithm
-	static std::vector<std::vector<Atom*> > all_small_rings_;
-
-	/// contains all 3 to 6 membered rings as beers
-	static std::vector<BitVector> all_small_beers_;
-
-	/*_ function that gets a binary edge-encoded ring as a BitVector
-					and adds it to the ringset if its linearly independend
-			*/
-	static void BalducciPearlmanRingSelector_(BitVector bit_vector);
-	
-	/*_ Implementation of the Balducci/Pearlman algorithm
-			*/
-	Size BalducciPearlmanAlgorithm_(std::vector<std::vector<Atom*> >& sssr, SimpleMolecularGraph& graph);
+	/// the rings of the last call of calculateSSSR
+	boost::shared_ptr<RingSet> ring_set_;
 };
 
 
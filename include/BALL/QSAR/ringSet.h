@@ -0,0 +1,151 @@
+// -*- Mode: C++; tab-width: 2; -*-
+// vi: set ts=2:
+//
+
+#ifndef BALL_QSAR_RINGSET_H
+#define BALL_QSAR_RINGSET_H
+
+#ifndef BALL_CONCEPT_PERSISTENTOBJECT_H
+#include <BALL/CONCEPT/persistentObject.h>
+#endif
+
+#ifndef BALL_COMMON_CREATE_H
+#include <BALL/COMMON/create.h>
+#endif
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+namespace BALL
+{
+	class Atom;
+	class AtomContainer;
+	class Bond;
+
+	/**	The rings of an AtomContainer.
+			\ingroup QSAR
+
+			The molecular graph consists of all atoms of the container and all bonds
+			between them, except for hydrogen bonds and disulphide bridges. Its
+			biconnected components are found in linear time; bridges and the atoms outside
+			of any ring are dropped before the rings are searched. Every component with
+			cycles is handled separately:
+
+			- The SSSR (a minimum cycle basis) is selected from Horton's candidate cycles,
+			  formed by the shortest path trees from every atom, by Gaussian elimination
+			  over the edge sets of the candidates in order of increasing size.
+			- All simple rings with up to six atoms are enumerated by a depth-limited search.
+
+			The atoms of every ring are given in the order of the ring.
+
+			get() stores the RingSet as the named property "RingSet" of the container and
+			returns the stored one as long as the atoms and bonds of the container have not
+			changed, so all processors that perceive rings (RingPerceptionProcessor, and
+			through it RingAnalyser, SmartsMatcher, AromaticityProcessor, MMFF94, ...) share
+			the rings of a molecule. Changes of the bond orders do not invalidate the rings.
+	*/
+	class BALL_EXPORT RingSet
+		:	public PersistentObject
+	{
+		public:
+
+			BALL_CREATE(RingSet)
+
+			/// The name of the property the rings are stored in
+			static const char* PROPERTY_NAME;
+
+			/** @name Constructors and Destructors
+			*/
+			//@{
+
+			/// Default constructor
+			RingSet();
+
+			/// Copy constructor
+			RingSet(const RingSet& ring_set);
+
+			/// Destructor
+			virtual ~RingSet();
+
+			/// Assignment operator
+			RingSet& operator = (const RingSet& ring_set);
+
+			/// Clear all rings
+			void clear();
+			//@}
+
+			/** @name Ring perception
+			*/
+			//@{
+
+			/// Perceive the rings of ac
+			void compute(AtomContainer& ac);
+
+			/// Return true if the rings were perceived for ac and its atoms and bonds did not change since
+			bool isValid(const AtomContainer& ac) const;
+
+			/** Return the rings of ac.
+			 *  The rings stored in ac are returned if they are still valid, otherwise
+			 *  they are perceived and stored.
+			 */
+			static boost::shared_ptr<RingSet> get(AtomContainer& ac);
+
+			/// Remove the rings stored in ac
+			static void invalidate(AtomContainer& ac);
+			//@}
+
+			/** @name Accessors
+			*/
+			//@{
+
+			/// Return the smallest set of smallest rings
+			const std::vector<std::vector<Atom*> >& getSSSR() const { return sssr_; }
+
+			/// Return all rings with three to six atoms
+			const std::vector<std::vector<Atom*> >& getSmallRings() const { return small_rings_; }
+
+			/// Return the atoms of every biconnected component containing rings
+			const std::vector<std::vector<Atom*> >& getRingSystems() const { return ring_systems_; }
+			//@}
+
+			/** @name Storers
+			 *  Only the class is written. Read rings are never valid and are perceived again.
+			 */
+			//@{
+			virtual void persistentWrite(PersistenceManager& pm, const char* name = 0) const;
+
+			virtual void persistentRead(PersistenceManager& pm);
+			//@}
+
+		protected:
+
+			/// A biconnected component, with atom and bond indices local to the component
+			struct Component_
+			{
+				std::vector<Position>                               atoms;
+				std::vector<std::pair<Position, Position> >         bonds;
+				// for every atom: pairs of neighbour and bond
+				std::vector<std::vector<std::pair<Position, Position> > > neighbours;
+			};
+
+			/// Compute the SSSR of a component
+			void computeSSSR_(const Component_& component, const std::vector<Atom*>& atoms);
+
+			/// Enumerate all rings with up to six atoms of a component
+			void computeSmallRings_(const Component_& component, const std::vector<Atom*>& atoms);
+
+			/// Return true if the bond is part of the molecular graph
+			static bool isGraphBond_(const Bond& bond);
+
+			std::vector<std::vector<Atom*> > sssr_;
+			std::vector<std::vector<Atom*> > small_rings_;
+			std::vector<std::vector<Atom*> > ring_systems_;
+
+			// the atoms of the container, each followed by the partners of its bonds and a 0
+			std::vector<const Atom*>         signature_;
+	};
+
+} // namespace BALL
+
+#endif // BALL_QSAR_RINGSET_H
@@ -31,6 +31,17 @@ namespace BALL
 
 			void testOverlaps(Vector3& position, HashGrid3<Atom*>* hashg = NULL);
 
+			/** Prepares calculateScoreLowerBound() for the current ligand. \n
+			A bound can only be given if the score of the ligand conformation and of all receptor-ligand ScoringComponents that are not precalculated does not depend on the pose,
+			if all Constraints are ReferenceAreas, and if neither flexible residues nor receptor conformations are used.
+			@return false if no lower bound can be calculated with the current setup */
+			bool setupScoreLowerBound();
+
+			/** Calculates a lower bound for the score of all poses of the current ligand that leave the atoms marked in fixed_atoms in place. \n
+			For those atoms, the contributions in atom_scores (as obtained by getLigandAtomScores() for a pose with the same positions) are used;
+			for all other atoms, the lowest value of the ScoreGrids is used. setupScoreLowerBound() has to be called before. */
+			double calculateScoreLowerBound(const std::vector<double>& atom_scores, const std::vector<bool>& fixed_atoms) const;
+
 		protected:
 			//ForceField* force_field_;
 
@@ -38,6 +49,12 @@ namespace BALL
 			@param set the id of the ScoreGrid, whose HashGrid is to be used */
 			void updatePrecalculatedScore(Size set);
 
+			/** lower bounds of the contributions of each ligand atom to the grid score, see setupScoreLowerBound() */
+			std::vector<double> atom_score_lower_bounds_;
+
+			/** the pose-independent part of the score of the current ligand, see setupScoreLowerBound() */
+			double constant_score_;
+
 		private:
 
 	};
@@ -12,6 +12,16 @@
 #include <set>
 #include <map>
 
+#include <boost/shared_ptr.hpp>
+
+namespace boost
+{
+	namespace iostreams
+	{
+		class mapped_file_source;
+	}
+}
+
 namespace BALL
 {
 	class ScoreGridSet;
@@ -28,12 +38,20 @@ namespace BALL
 
 				/** determines whether or not interpolation should be used in order to calculated the score from the precalculated ScoreGridSets. */
 				static const char* SCOREGRID_INTERPOLATION;
+
+				/** directory in which the ScoreGridSets of receptor conformations added by addReceptorConformation() are cached as binary files. If empty, ScoreGridSets are kept in memory only and evicted ones have to be recalculated. */
+				static const char* ENSEMBLE_CACHE_DIRECTORY;
+
+				/** the maximal amount of memory (in MB) that may be occupied by loaded ScoreGridSets of receptor conformations. If necessary, the least recently used ScoreGridSets are evicted. */
+				static const char* ENSEMBLE_MEMORY_LIMIT;
 			};
 
 			struct Default
 			{
 				static double SCOREGRID_RESOLUTION;
 				static bool SCOREGRID_INTERPOLATION;
+				static String ENSEMBLE_CACHE_DIRECTORY;
+				static Size ENSEMBLE_MEMORY_LIMIT;
 			};
 
 			GridBasedScoring(AtomContainer& receptor, AtomContainer& ligand, Options& options);
@@ -61,13 +79,15 @@ namespace BALL
 			/** precalculate one Grid for each desired AtomType and one Grid for the electrostatic (q1/distance) */
 			void precalculateGrids(bool ony_flexRes_grids = false);
 
-			/** saves all previously calculated Grids to the specified file */
+			/** saves all previously calculated Grids to the specified file. \n
+			The format is chosen by the extension of the file: .grd (text), .grd.gz, .bngrd (binary), .bngrd.gz, .mgrd (memory-mappable) or .mgrd16 (memory-mappable with 16 bit values, which saturate beyond +/-65504; see ScoreGridSet::mappableWrite()) */
 			void saveGridSetsToFile(String file, String receptor_name);
 
 			/** restores GridSet from the given file and appends it to the current ScoreGridSets */
 			void readAdditionalGridSetFromFile(String file);
 
-			/** deletes all existing ScoreGridSet and creates a new one from a given file */
+			/** deletes all existing ScoreGridSet and creates a new one from a given file. \n
+			Files in .mgrd or .mgrd16 format are memory-mapped read-only instead of being read, so that several processes using the same file share one copy of the grids. */
 			void replaceGridSetFromFile(String file);
 
 			/** Load precalculated ScoreGridSets for the given residues from files. \n
@@ -86,13 +106,108 @@ namespace BALL
 			/** Returns the average number of receptor atoms neighboring each ligand atom as determined by the last call of calculateGridScore() (which is called by update()). */
 			int getNoNeighboringReceptorAtoms();
 
+			/** Returns, for each atom of the current ligand (in the order of its AtomIterator), its contribution to the grid score as determined by the last call of calculateGridScore() (which is called by updateScore()), before the scaling by depth of burial. */
+			const std::vector<double>& getLigandAtomScores() const;
+
 			std::vector<ScoreGridSet*>* getScoreGridSets();
 
 			void validateGridSets();
 
+			/** @name Receptor conformation ensembles
+			 *  A ligand can be scored against several conformations of the receptor at once. For each conformation, a receptor ScoreGridSet with the same dimensions as the one of the original receptor is created.
+			 *  Those ScoreGridSets are identified by a hash-key of the receptor coordinates and all grid-relevant options, are calculated or mapped from the cache directory only when needed, and are evicted in least-recently-used order if the memory limit is exceeded. Conformations with the same key share one ScoreGridSet. \n
+			 *  Note that only the precalculated (gridable) score contributions differ between receptor conformations.
+			 */
+			//@{
+
+			/** adds a conformation of the receptor to the ensemble.
+			 @param conformation an AtomContainer that contains the same atoms in the same order as the receptor, but with different coordinates
+			 @return the index of the new conformation */
+			Size addReceptorConformation(const AtomContainer& conformation);
+
+			/** returns the number of receptor conformations that were added by addReceptorConformation() */
+			Size getNumberOfReceptorConformations() const;
+
+			/** returns the hash-key that identifies the ScoreGridSet of the specified receptor conformation */
+			const String& getReceptorConformationKey(Size conformation) const;
+
+			/** use the ScoreGridSet of the specified receptor conformation instead of the one of the original receptor for all following score calculations. \n
+			 The ScoreGridSet is calculated or loaded from the cache directory if necessary. */
+			void activateReceptorConformation(Size conformation);
+
+			/** use the ScoreGridSet of the original receptor again */
+			void deactivateReceptorConformations();
+
+			/** returns the index of the currently active receptor conformation or -1 if the original receptor is used */
+			int getActiveReceptorConformation() const;
+
+			/** make sure that ScoreGridSets for all receptor conformations exist in the cache directory (or in memory, if no cache directory has been set) */
+			void precalculateReceptorConformationGrids();
+
+			/** scores the current ligand pose against all receptor conformations and keeps the one with the best score active.
+			 update() has to be called before this function, just as for updateScore(). IMGDock uses this function instead of updateScore() as soon as receptor conformations have been added.
+			 @param best_conformation the index of the receptor conformation yielding the best score
+			 @return the best score */
+			double updateEnsembleScore(Size& best_conformation);
+
+			/** returns the number of bytes currently occupied by loaded ScoreGridSets of receptor conformations */
+			LongSize getEnsembleMemoryUsage() const;
+
+			/** returns the number of distinct ScoreGridSets of receptor conformations that are currently loaded */
+			Size getNumberOfLoadedReceptorConformationGrids() const;
+
+			/** removes all receptor conformations and their ScoreGridSets; the original receptor is used again */
+			void clearReceptorConformations();
+			//@}
+
 		protected:
 			void setup();
 
+			struct ReceptorConformation
+			{
+				/** coordinates of all receptor atoms in this conformation */
+				std::vector<Vector3> positions;
+
+				/** hash-key of coordinates and grid options; used as name of the cache file */
+				String key;
+			};
+
+			struct EnsembleGridSet
+			{
+				/** the ScoreGridSet shared by all receptor conformations with the same key */
+				ScoreGridSet* grid_set;
+
+				/** value of ensemble_clock_ at the last time this ScoreGridSet was used */
+				Size last_use;
+			};
+
+			/** calculates the hash-key for the given receptor coordinates and the current grid options */
+			String calculateConformationKey_(const std::vector<Vector3>& positions);
+
+			/** returns the ScoreGridSet for the given conformation, which is loaded or calculated if necessary */
+			ScoreGridSet* loadReceptorConformationGrids_(Size conformation);
+
+			/** calculates a new ScoreGridSet for the given receptor conformation */
+			ScoreGridSet* calculateReceptorConformationGrids_(Size conformation);
+
+			/** maps a cached ScoreGridSet from the given file; returns NULL if the file is missing or invalid */
+			ScoreGridSet* mapCachedGridSet_(const String& file);
+
+			/** writes a ScoreGridSet to the cache; a temporary file is renamed afterwards, so that concurrent processes never see a partially written file */
+			void writeCachedGridSet_(ScoreGridSet* sgs, const String& file);
+
+			/** maps the given ScoreGridSet file read-only into memory */
+			static boost::shared_ptr<boost::iostreams::mapped_file_source> mapGridFile_(const String& file);
+
+			/** evicts least recently used ScoreGridSets until the given number of additional bytes fits into the memory limit */
+			void evictReceptorConformationGrids_(LongSize required_bytes);
+
+			/** returns the number of bytes needed to store the given ScoreGridSet, i.e. doubles for calculated and floats or 16 bit floats for mapped grids */
+			static LongSize getGridSetMemory_(ScoreGridSet* sgs);
+
+			/** precalculate the ScoreGridSets with indices start to end-1 */
+			void precalculateGrids_(int start, int end);
+
 			struct GridSetsResult
 			{
 				/** contains one energy value per GridSet */
@@ -110,9 +225,16 @@ namespace BALL
 			/** saves the final and all intermediate results of the last call of updateScore() */
 			GridSetsResult gridsets_result_;
 
+			/** the contribution of each ligand atom to the last result of calculateGridScore() */
+			std::vector<double> ligand_atom_scores_;
+
 			/** calculates the score for the interaction between the receptor and the current ligand conformation by use of the precalculated GridSets */
 			double calculateGridScore();
 
+			/** calculates, for each atom of the current ligand, a lower bound of its contribution to calculateGridScore() at any position, using the extreme cell values of the enabled ScoreGridSets. \n
+			Since the scaling by depth of burial does only increase the sum of these contributions if interaction_no_scale_ >= 1, false is returned for ScoreGridSets with a smaller value. */
+			bool calculateAtomScoreLowerBounds_(std::vector<double>& lower_bounds);
+
 			/** creates a new ScoreGridSet for receptor_ according to dimensions/properties of ScoringFunction::hashgrid_ \n
 			See class ScoreGridSet for documentation of the other parameters
 			@param size the number of grid cell on each axis */
@@ -156,6 +278,33 @@ namespace BALL
 			These ScoreGridSets are not used directly during updateScore() (and therefore they are not put into grid_sets_), but their scores are added to the one ScoreGridSet that holds the score-sums of all flexible residues by loadFlexibleResidueScoreGrids(). */
 			std::map<const Residue*, ScoreGridSet*> flex_gridsets_;
 
+			/** all receptor conformations added by addReceptorConformation() */
+			std::vector<ReceptorConformation> receptor_conformations_;
+
+			/** the loaded ScoreGridSets of receptor conformations, indexed by their keys */
+			std::map<String, EnsembleGridSet> ensemble_grid_sets_;
+
+			/** the ScoreGridSet of the original receptor while a receptor conformation is active */
+			ScoreGridSet* original_receptor_gridset_;
+
+			/** index of the active receptor conformation or -1 */
+			int active_conformation_;
+
+			/** counter that is incremented each time a receptor conformation is used */
+			Size ensemble_clock_;
+
+			/** see Option::ENSEMBLE_CACHE_DIRECTORY */
+			String ensemble_cache_directory_;
+
+			/** see Option::ENSEMBLE_MEMORY_LIMIT; in bytes */
+			LongSize ensemble_memory_limit_;
+
+			/** the keys of all ScoreGridSets of receptor conformations that have been evicted so far */
+			std::set<String> evicted_ensemble_keys_;
+
+			/** has the user already been warned that the memory limit makes ScoreGridSets being evicted and loaded again? */
+			bool ensemble_thrashing_reported_;
+
 			friend class ScoreGridSet;
 			friend class PharmacophoreConstraint;
 	};
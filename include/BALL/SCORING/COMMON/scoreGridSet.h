@@ -11,6 +11,15 @@
 #include <BALL/DATATYPE/regularData3D.h>
 #include <BALL/DOCKING/COMMON/constraints.h>
 
+#include <boost/shared_ptr.hpp>
+
+namespace boost
+{
+	namespace iostreams
+	{
+		class mapped_file_source;
+	}
+}
 
 namespace BALL
 {
@@ -60,6 +69,24 @@ namespace BALL
 
 			void readFromFile(std::istream& input);
 
+			/** Writes this ScoreGridSet in a page-aligned binary format that can be memory-mapped by mapFromFile(). \n
+			The header and each grid start at a multiple of MAPPED_PAGE_SIZE relative to the current position of the stream, so several ScoreGridSets can be written to the same file one after another.
+			@param half_precision if set to true, all values are stored as IEEE 754 16 bit floating point numbers, i.e. with 11 significant bits (a relative error of at most 0.05%). The representable range is limited to [-65504, 65504]: values of larger magnitude, including infinity (e.g. sterical clashes), saturate and are read back as 1e10 or -1e10, and magnitudes below 6e-8 are read back as 0. Grids whose values have to be preserved beyond this range must be written with full (32 bit) precision. */
+			void mappableWrite(std::ostream& output, bool half_precision = false);
+
+			/** Maps a ScoreGridSet that was written by mappableWrite() read-only into memory. \n
+			The grids are not copied, so that all processes mapping the same file share one physical copy. Functions that modify the grids cannot be used for a mapped ScoreGridSet.
+			@param file a file that has been mapped as a whole, shared by all ScoreGridSets stored in it
+			@param offset the position of this ScoreGridSet within the file
+			@return the position of the data following this ScoreGridSet */
+			LongSize mapFromFile(boost::shared_ptr<boost::iostreams::mapped_file_source> file, LongSize offset = 0);
+
+			/** returns true if the grids of this ScoreGridSet are memory-mapped from a file */
+			bool isMapped() const;
+
+			/** alignment (in bytes) of the header and the grids written by mappableWrite() */
+			static const Size MAPPED_PAGE_SIZE;
+
 			void setHashGrid(HashGrid3<Atom*>* hashgrid);
 
 			HashGrid3<Atom*>* getHashGrid();
@@ -119,6 +146,15 @@ namespace BALL
 			/** Get the atom-type name for the specified grid */
 			String getGridAtomTypeName(int grid_id);
 
+			/** Insert the given atom-type into the map of atom-types if replace is true, else check that it matches the one already stored for the specified grid */
+			void registerGridAtomType_(Size grid_id, const String& type_name, bool replace);
+
+			/** returns the value of the given cell, regardless of whether the grids are stored in memory or are memory-mapped */
+			double getCellValue_(Size grid, Size x, Size y, Size z) const;
+
+			/** releases a memory-mapped file (if any) */
+			void unmap_();
+
 			/** are the scores taken from another ScoreGridSet? (which is the case when using several ScoreGridSets for the same molecule, e.g. water, at once) */
 			bool is_reference_;
 
@@ -174,6 +210,21 @@ namespace BALL
 
 			PharmacophoreConstraint* pharm_constraint_;
 
+			/** the mapped file, if the grids of this ScoreGridSet are memory-mapped */
+			boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file_;
+
+			/** start of the first mapped grid */
+			const char* mapped_data_;
+
+			/** number of mapped grids */
+			Size mapped_no_grids_;
+
+			/** distance between the first cells of two consecutive mapped grids in bytes */
+			LongSize mapped_grid_stride_;
+
+			/** are mapped values stored as 16 bit floating point numbers? */
+			bool mapped_half_precision_;
+
 			friend class GridBasedScoring;
 	};
 }
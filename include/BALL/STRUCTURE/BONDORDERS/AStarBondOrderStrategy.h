@@ -26,6 +26,22 @@ namespace BALL
 	 *  This class implements an AStar approach for the bond order assignment
 	 *  problem that can be used by the \link AssignBondOrderProcessor
 	 *  AssignBondOrderProcessor \endlink.
+	 *
+	 *  Two search strategies are available (see Option::SEARCH_STRATEGY):
+	 *
+	 *  - Search::BEST_FIRST is the classical AStar search. Its search frontier is
+	 *    kept between calls to computeNextSolution(), so the k next best solutions
+	 *    are obtained by simply continuing the search. The nodes of the search tree
+	 *    are stored relative to their parents, i.e., a node only costs a few bytes
+	 *    instead of a full bond order vector.
+	 *  - Search::ITERATIVE_DEEPENING is a memory bounded IDA* variant that only needs
+	 *    memory linear in the number of bonds. It explores the search tree depth first
+	 *    in bands of increasing penalty; all solutions of a band are collected and then
+	 *    handed out in order, before the next band is searched.
+	 *
+	 *  In both cases, the lower bounds of the unclosed atoms are memoized in a
+	 *  \link PenaltyBoundCache PenaltyBoundCache \endlink, which makes the
+	 *  penalty estimation of a search node considerably cheaper.
 	 */
 	class AStarBondOrderStrategy
 		: public BondOrderAssignmentStrategy
@@ -43,11 +59,18 @@ namespace BALL
 				 * @see Option::Heuristic::TIGHT
 				*/
 				static const char* HEURISTIC;
+
+				/**	the search strategy
+				 * @see Search::BEST_FIRST
+				 * @see Search::ITERATIVE_DEEPENING
+				*/
+				static const char* SEARCH_STRATEGY;
 			};
 
 			struct BALL_EXPORT Default
 			{
 				static const String HEURISTIC;
+				static const String SEARCH_STRATEGY;
 			};
 
 			struct BALL_EXPORT Heuristic
@@ -56,6 +79,15 @@ namespace BALL
 				static const String MEDIUM;
 				static const String TIGHT;
 			};
+
+			struct BALL_EXPORT Search
+			{
+				/// best first search keeping the whole frontier in memory
+				static const String BEST_FIRST;
+
+				/// memory bounded iterative deepening search
+				static const String ITERATIVE_DEEPENING;
+			};
 			//@}
 
 			AStarBondOrderStrategy(AssignBondOrderProcessor* parent);
@@ -70,18 +102,112 @@ namespace BALL
 
 			virtual boost::shared_ptr<BondOrderAssignment> computeNextSolution();
 
+			virtual bool isExact() const;
+
+			/// Return the number of search nodes expanded since the last call of init()
+			Size getNumberOfNodeExpansions() const { return step_; }
+
+			/// Return the number of search nodes currently held in memory
+			Size getNumberOfStoredNodes() const { return nodes_.size() + band_solutions_.size(); }
+
+			/// Return the cache of memoized lower bounds
+			const PenaltyBoundCache& getPenaltyBoundCache() const { return bound_cache_; }
+
 		protected:
 
+			/// A node of the search tree, stored relative to its parent
+			struct SearchNode_
+			{
+				/// the index of the parent node, or -1 for the nodes of the first bond
+				Index parent;
+				/// the bond fixed in this node
+				Position last_bond;
+				/// the order of this bond
+				short order;
+				float estimated_atom_type_penalty;
+				float estimated_bond_length_penalty;
+			};
+
+			/// Orders the node indices such that the best node is on top of the queue
+			class NodeComparator_
+			{
+				public:
+					NodeComparator_(const AStarBondOrderStrategy* strategy)
+						: strategy_(strategy)
+					{}
+
+					bool operator () (Position a, Position b) const
+					{
+						return strategy_->isWorse_(strategy_->nodes_[a], strategy_->nodes_[b]);
+					}
+
+				protected:
+					const AStarBondOrderStrategy* strategy_;
+			};
+
+			typedef std::priority_queue<Position, std::vector<Position>, NodeComparator_> NodeQueue_;
 
+			/// The same order as PartialBondOrderAssignment::operator <
+			bool isWorse_(const SearchNode_& a, const SearchNode_& b) const;
+
+			/// Collect the bond orders the given bond may take
+			void getBondOrderChoices_(Position bond, std::vector<short>& orders) const;
+
+			/// Estimate the penalty of the partial assignment held in entry_
+			bool estimatePenalty_();
+
+			/// Store entry_ as a child of the given node and add it to the queue
+			void pushNode_(Index parent);
+
+			/// Rebuild entry_ from the given node
+			void restoreNode_(Position index);
+
+			/// Best first search
+			boost::shared_ptr<BondOrderAssignment> computeNextBestFirstSolution_();
+
+			/// Iterative deepening search
+			boost::shared_ptr<BondOrderAssignment> computeNextIterativeDeepeningSolution_();
+
+			/** Depth first search of the current band, starting at the given bond.
+			 *  @retval bool - false, if the search was cancelled
+			 */
+			bool searchBand_(Position bond);
 
 			/// The chosen heuristic
 			PartialBondOrderAssignment::HEURISTIC_INDEX heuristic_index_;
 
+			/// Use the iterative deepening search?
+			bool iterative_deepening_;
+
+			/// All nodes generated by the best first search
+			std::vector<SearchNode_> nodes_;
+
+			/// The priority queue of the best first search (indices into nodes_)
+			NodeQueue_ node_queue_;
+
+			/// The priority queue of the derived strategies
 			std::priority_queue<PartialBondOrderAssignment> queue_;
 
-			/// The priority queue. 
+			/// The partial assignment currently worked on
+			PartialBondOrderAssignment entry_;
+
+			/// Memoized lower bounds of unclosed atoms
+			PenaltyBoundCache bound_cache_;
+
+			/// The solutions of the current band of the iterative deepening search
+			std::priority_queue<PartialBondOrderAssignment> band_solutions_;
+
+			/// Solutions up to this penalty have already been handed out
+			float lower_threshold_;
+
+			/// The upper penalty of the current band
+			float threshold_;
+
+			/// The smallest penalty beyond the current band
+			float next_threshold_;
+
 			// The current number of node expansions. 
-			// step_ + queue_.size() gives the number of touched nodes.
+			// step_ + node_queue_.size() gives the number of touched nodes.
 			int step_;
 	};
 
@@ -207,6 +207,8 @@ namespace BALL
 			 */
 			virtual boost::shared_ptr<BondOrderAssignment> computeNextSolution();
 
+			virtual bool isExact() const;
+
 		protected:
 			/**
 			 * A DPConfig_ is an entry in a dynamic programming table. It holds the current bond-order assignments,
@@ -19,6 +19,9 @@ namespace BALL
 	 *  This class implements an Integer Linear Programming approach 
 	 *  for the bond order assignment problem that can be used by 
 	 *  the \link AssignBondOrderProcessor AssignBondOrderProcessor \endlink.
+	 *
+	 *  In a portfolio, the ILP strategy ignores the shared bound: lp_solve
+	 *  cannot be interrupted, so the strategy always runs to completion.
 	 */
 	class ILPBondOrderStrategy
 		: public BondOrderAssignmentStrategy
@@ -35,6 +38,8 @@ namespace BALL
 
 			virtual boost::shared_ptr<BondOrderAssignment> computeNextSolution();
 
+			virtual bool isExact() const;
+
 		protected:
 			bool valid_;
 
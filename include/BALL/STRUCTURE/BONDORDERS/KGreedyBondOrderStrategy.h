@@ -60,6 +60,8 @@ namespace BALL
 
 			virtual boost::shared_ptr<BondOrderAssignment> computeNextSolution();
 
+			virtual bool isExact() const;
+
 		protected:
 
 			float greedy_atom_type_penalty_;
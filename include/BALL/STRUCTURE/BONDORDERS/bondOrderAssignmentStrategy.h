@@ -10,6 +10,7 @@
 #endif
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
 namespace BALL
 {
@@ -26,6 +27,35 @@ namespace BALL
 	class BALL_EXPORT BondOrderAssignmentStrategy
 	{
 		public:
+			/** The state shared by strategies racing on the same molecule.
+			 *
+			 *  Strategies report the penalty of their first solution as incumbent,
+			 *  may use the incumbent to prune their search, and stop as soon as
+			 *  the portfolio has been cancelled. All methods are thread safe.
+			 */
+			class BALL_EXPORT SharedBound
+			{
+				public:
+					SharedBound();
+
+					/// Return the best penalty reported so far, or a very large value if there is none
+					float getIncumbent() const;
+
+					/// Report the penalty of a solution. Returns true if it improves the incumbent.
+					bool offer(float penalty);
+
+					/// Ask all strategies sharing this bound to stop
+					void cancel();
+
+					/// Has the portfolio been cancelled?
+					bool isCancelled() const;
+
+				protected:
+					mutable boost::mutex mutex_;
+					float incumbent_;
+					bool  cancelled_;
+			};
+
 			BondOrderAssignmentStrategy(AssignBondOrderProcessor* parent);
 
 			virtual boost::shared_ptr<BondOrderAssignment> computeNextSolution() = 0;
@@ -33,10 +63,26 @@ namespace BALL
 			virtual void setDefaultOptions();
 			virtual void clear();
 			virtual void init() = 0;
+
+			/** Is the first solution of this strategy guaranteed to be optimal?
+			 *  Exact strategies end a portfolio run as soon as they have found a solution.
+			 */
+			virtual bool isExact() const;
+
+			/// Share the incumbent with other strategies. Pass an empty pointer to run alone.
+			void setSharedBound(boost::shared_ptr<SharedBound> bound);
 		
 			/// Our parent processor
 			AssignBondOrderProcessor* abop;
 
+		protected:
+			/// Has our portfolio been cancelled?
+			bool isCancelled_() const;
+
+			/// The incumbent of our portfolio, or a very large value if we run alone
+			float getIncumbent_() const;
+
+			boost::shared_ptr<SharedBound> shared_bound_;
 	};
 }
 #endif // BALL_STRUCTURE_BONDORDERS_BONDORDERASSIGNMENTSTRATEGY_H
@@ -13,6 +13,10 @@
 # include <BALL/KERNEL/bond.h>
 #endif
 
+#ifndef BALL_DATATYPE_HASHMAP_H
+# include <BALL/DATATYPE/hashMap.h>
+#endif
+
 #include <boost/shared_ptr.hpp>
 #include <vector>
 
@@ -21,6 +25,46 @@ namespace BALL
 	class AssignBondOrderProcessor;
 	class BondOrderAssignment;
 
+	/** \brief Memoized lower bounds for the penalties of unclosed atoms.
+	 *
+	 *  For the SIMPLE and MEDIUM heuristics, the estimated atom type and bond length
+	 *  penalties of an unclosed atom only depend on the atom, its fixed valence, its fixed
+	 *  number of virtual hydrogens and its number of free bonds (the free bonds of an atom
+	 *  are always the ones with the largest bond indices). A search touches the same
+	 *  combinations over and over again, so the bounds are computed once and looked up
+	 *  afterwards. A cache belongs to a single molecule and must be cleared in between.
+	 */
+	class BALL_EXPORT PenaltyBoundCache
+	{
+		public:
+			PenaltyBoundCache();
+
+			/// Forget all stored bounds
+			void clear();
+
+			/** Look up the bounds for an unclosed atom.
+			 *  @return false if the bounds have not been stored yet
+			 */
+			bool get(Index atom_index, int fixed_valence, int fixed_virtual_order, int num_free_bonds,
+			         float& atom_type_penalty, float& bond_length_penalty) const;
+
+			/// Store the bounds for an unclosed atom. Negative values flag invalid states.
+			void set(Index atom_index, int fixed_valence, int fixed_virtual_order, int num_free_bonds,
+			         float atom_type_penalty, float bond_length_penalty);
+
+			/// Return the number of stored bounds
+			Size size() const { return bounds_.size(); }
+
+			/// Return the number of successful lookups since the last clear()
+			Size getNumberOfHits() const { return hits_; }
+
+		protected:
+			static LongSize key_(Index atom_index, int fixed_valence, int fixed_virtual_order, int num_free_bonds);
+
+			HashMap<LongSize, std::pair<float, float> > bounds_;
+			mutable Size hits_;
+	};
+
 	/** \brief A full or partial solution to the AStar-based bond order assignment problem.
 	 *  
 	 *  This class represents a full or partial bond order assignment. It is a very basic representation
@@ -72,10 +116,14 @@ namespace BALL
 			 *  include_heuristic_term == true, otherwise compute only f = g*. The
 			 *  result is stored in the PartialBondOrderAssignment entry's member estimated_atom_type_penalty.
 			 *
+			 *  If a cache is given, the bounds of unclosed atoms are memoized in it (this is
+			 *  ignored for the TIGHT heuristic, whose bounds depend on the neighbourhood).
+			 *
 			 *  @retval bool - true, if the entry is still valid.
 			 *  @retval bool - false otherwise.
 			 */
-			bool estimatePenalty_(bool include_heuristic_term = true, HEURISTIC_INDEX heuristic_index = SIMPLE);
+			bool estimatePenalty_(bool include_heuristic_term = true, HEURISTIC_INDEX heuristic_index = SIMPLE,
+			                      PenaltyBoundCache* cache = 0);
 
 			/// Estimates the atom type penalty for a given unclosed atom.
 			float estimateAtomTypePenalty_(Atom* atom,
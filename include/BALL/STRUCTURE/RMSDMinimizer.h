@@ -13,6 +13,13 @@
 #	include <BALL/MATHS/matrix44.h>
 #endif
 
+#include <vector>
+
+#ifdef BALL_HAS_TBB
+# include <tbb/parallel_for.h>
+# include <tbb/blocked_range.h>
+#endif
+
 namespace BALL
 {
 
@@ -24,6 +31,15 @@ namespace BALL
 			the RMSD-optimal transformation by solving an eigenvalue
 			problem.
 			 \par
+			For superimposing many frames (e.g. conformers or the snapshots
+			of a trajectory) onto the same reference, computeRMSDs() works
+			on contiguous blocks of single precision coordinates. It uses
+			the quaternion characteristic polynomial (QCP) method by
+			Theobald (Acta Cryst. A61, 478 (2005)), which determines the
+			largest eigenvalue by a Newton iteration instead of a full
+			eigendecomposition, and processes the frames in parallel if
+			BALL was built with TBB.
+			 \par
 	\ingroup StructureMapping
 	*/
 	class BALL_EXPORT RMSDMinimizer
@@ -55,6 +71,77 @@ namespace BALL
 		static double minimizeRMSD(AtomContainer& a, AtomContainer& b)
 			throw(RMSDMinimizer::IncompatibleCoordinateSets, RMSDMinimizer::TooFewCoordinates);
 
+		/** Superimpose a number of frames onto a reference.
+				The coordinates are stored as x, y, z for each atom, the frames one after another.
+				@param reference the coordinates of the reference
+				@param frames the coordinates of all frames
+				@param number_of_atoms the number of atoms of the reference and of each frame
+				@param number_of_frames the number of frames
+				@param rmsds the RMSD of each frame after optimal superposition
+				@param transformations if not 0, the transformations mapping each frame onto the reference are stored here
+				@param run_parallel process the frames in parallel (ignored if BALL was built without TBB)
+		*/
+		static void computeRMSDs(const float* reference, const float* frames, Size number_of_atoms, Size number_of_frames,
+		                         std::vector<double>& rmsds, std::vector<Matrix4x4>* transformations = 0, bool run_parallel = true)
+			throw(RMSDMinimizer::TooFewCoordinates);
+
+		/** Superimpose a number of frames onto a reference.
+				The number of frames is determined by the sizes of the coordinate vectors.
+				@see computeRMSDs(const float*, const float*, Size, Size, std::vector<double>&, std::vector<Matrix4x4>*, bool)
+		*/
+		static void computeRMSDs(const std::vector<float>& reference, const std::vector<float>& frames,
+		                         std::vector<double>& rmsds, std::vector<Matrix4x4>* transformations = 0, bool run_parallel = true)
+			throw(RMSDMinimizer::IncompatibleCoordinateSets, RMSDMinimizer::TooFewCoordinates);
+
+		protected:
+
+		/** Superimpose the frames [begin, end) onto the centered reference.
+		 */
+		static void computeFrameRange_(const std::vector<double>& reference, const Vector3& reference_center,
+		                               double reference_inner_product, const float* frames, Size number_of_atoms,
+		                               Size begin, Size end, std::vector<double>& rmsds, std::vector<Matrix4x4>* transformations);
+
+#ifdef BALL_HAS_TBB
+		/** A nested class used for superimposing the frames in parallel.
+		 */
+		class ComputeFrameRangeTask_
+		{
+			public:
+				ComputeFrameRangeTask_(const std::vector<double>& reference, const Vector3& reference_center,
+				                       double reference_inner_product, const float* frames, Size number_of_atoms,
+				                       std::vector<double>& rmsds, std::vector<Matrix4x4>* transformations)
+					: reference_(reference),
+					  reference_center_(reference_center),
+					  reference_inner_product_(reference_inner_product),
+					  frames_(frames),
+					  number_of_atoms_(number_of_atoms),
+					  rmsds_(rmsds),
+					  transformations_(transformations)
+				{ }
+
+				void operator() (const tbb::blocked_range<size_t>& r) const
+				{
+					RMSDMinimizer::computeFrameRange_(reference_, reference_center_, reference_inner_product_, frames_,
+					                                  number_of_atoms_, r.begin(), r.end(), rmsds_, transformations_);
+				}
+
+			protected:
+				const std::vector<double>& reference_;
+
+				Vector3 reference_center_;
+
+				double reference_inner_product_;
+
+				const float* frames_;
+
+				Size number_of_atoms_;
+
+				std::vector<double>& rmsds_;
+
+				std::vector<Matrix4x4>* transformations_;
+		};
+#endif
+
  };
 
 }	// namespace BALL
@@ -15,6 +15,11 @@
 
 #include <vector>
 
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
 namespace BALL
 {
 	class Residue;
@@ -53,6 +58,13 @@ namespace BALL
 	 * the obtained hydrogen atom positions using a force field
 	 * (e.g. \ref BALL::AmberFF, \ref BALL::CharmmFF, \ref BALL::MMFF94)
 	 *
+	 * For large structures, \ref setRunParallel enables a deferred mode: operator() only
+	 * collects the atoms, and \ref finish computes the hydrogen positions of all atoms
+	 * concurrently (if BALL was built with TBB). The positions of an atom's hydrogens only
+	 * depend on the atom and its direct neighbours, so this does not need to touch the
+	 * \ref Composite tree. The new atoms are then created in a single pass in atom order,
+	 * which gives exactly the same result as the serial mode.
+	 *
 	 * \ingroup StructureMiscellaneous
 	 */
 	class BALL_EXPORT AddHydrogenProcessor
@@ -88,6 +100,15 @@ namespace BALL
 			 */
 			virtual Processor::Result operator() (Composite &composite);
 
+			/**
+			 * In the deferred mode, adds the hydrogens to all atoms collected by operator().
+			 *
+			 * \see UnaryProcessor::finish()
+			 *
+			 * \return true in all cases
+			 */
+			virtual bool finish();
+
 			/**
 			 * Computes the number of connections of a provided \ref Atom
 			 * the computation is solely based on the formal charge of the molecule
@@ -117,7 +138,95 @@ namespace BALL
 			 */
 			Size getNumberOfAddedHydrogens() const { return nr_hydrogens_;}
 
+			/**
+			 * Enables or disables the deferred, parallel mode (disabled by default).
+			 * In this mode, the hydrogens are not added before \ref finish is called,
+			 * which happens automatically when the processor is applied to a composite.
+			 */
+			void setRunParallel(bool run_parallel) { run_parallel_ = run_parallel; }
+
+			/// Returns true if the deferred, parallel mode is enabled
+			bool getRunParallel() const { return run_parallel_; }
+
 		protected:
+			/// A simulated bond partner of an atom that is about to be saturated
+			struct Partner_
+			{
+				/// the partner atom, or 0 if it is a hydrogen that is not created yet
+				Atom* atom;
+				/// the index of the planned hydrogen if atom is 0
+				Position hydrogen;
+				Vector3 position;
+				bool is_hydrogen;
+			};
+
+			/// The hydrogens to be added to a single atom
+			struct Plan_
+			{
+				Atom* atom;
+				/// the value of the atom counter the plan starts with
+				Position first_atom_nr;
+				/// the positions of the new hydrogens and the atom counter used for their names
+				std::vector<std::pair<Vector3, Position> > hydrogens;
+				/// existing hydrogens that have to be moved
+				std::vector<std::pair<Atom*, Vector3> > moved;
+				/// the value of the atom counter after the last hydrogen
+				Position last_atom_nr;
+			};
+
+			/// Environment of the atom to be saturated, including the planned hydrogens
+			struct Environment_
+			{
+				std::vector<Partner_> partners;
+				/// the number of bonds, including the ones to the planned hydrogens
+				Size number_of_bonds;
+				/// true if a bond without partner atom was found
+				bool missing_partner;
+				Size sum_bond_orders;
+				bool first_bond_aromatic;
+				bool has_multiple_bond;
+				bool is_ring_atom;
+			};
+
+			/**
+			 * Computes the positions of all hydrogens to be added to plan.atom
+			 * without modifying the atom or the \ref Composite tree.
+			 */
+			void planHydrogens_(Plan_& plan) const;
+
+			/// One placement step, called recursively for every further batch of hydrogens
+			void planHydrogens_(Plan_& plan, Environment_& env, Position atom_nr) const;
+
+			/// Adds a planned hydrogen to plan and env
+			void planHydrogen_(Plan_& plan, Environment_& env, Position atom_nr, const Vector3& position) const;
+
+			/// Creates the hydrogens of a plan
+			void applyPlan_(const Plan_& plan);
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for computing the plans in parallel. */
+			class PlanTask_
+			{
+				public:
+					PlanTask_(const AddHydrogenProcessor* processor, std::vector<Plan_>& plans)
+						: processor_(processor),
+							plans_(plans)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						for (Position i=r.begin(); i!=r.end(); ++i)
+						{
+							processor_->planHydrogens_(plans_[i]);
+						}
+					}
+
+				protected:
+					const AddHydrogenProcessor* processor_;
+					std::vector<Plan_>& plans_;
+			};
+#endif
+
 			/**
 			 * Place peptide bond H-atoms according to Kabsch-Sander
 			 * \param res A pointer to a \ref Residue for which a peptide bond hydrogen should be placed
@@ -197,6 +306,8 @@ namespace BALL
 			Position atom_nr_;
 			Atom* last_atom_;
 			Size nr_hydrogens_;
+			bool run_parallel_;
+			std::vector<std::pair<Atom*, Position> > deferred_atoms_;
 	}; //class AddHydrogenProcessor
 
 } //namespace BALL
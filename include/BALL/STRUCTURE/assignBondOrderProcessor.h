@@ -52,6 +52,11 @@
 #include <map>
 #include <vector>
 
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
 namespace BALL
 {
 	/** \brief Assignment of bond orders from topology information.
@@ -223,6 +228,13 @@ namespace BALL
 				 */
 				static const char* APPLY_FIRST_SOLUTION;
 
+				/** the strategies raced by \link Algorithm::PORTFOLIO Algorithm::PORTFOLIO \endlink,
+				 *  as a comma separated list of algorithm names.
+				 *
+				 *  Default is "a_star,fpt".
+				 */
+				static const char* PORTFOLIO_ALGORITHMS;
+
 			};
 
 			/// Default values for options
@@ -245,6 +257,7 @@ namespace BALL
 				static const bool COMPUTE_ALSO_NON_OPTIMAL_SOLUTIONS;
 				static const float BOND_LENGTH_WEIGHTING;
 				static const bool APPLY_FIRST_SOLUTION;
+				static const String PORTFOLIO_ALGORITHMS;
 			};
 
 			struct BALL_EXPORT Algorithm
@@ -295,6 +308,26 @@ namespace BALL
 
 				static const String K_GREEDY;
 				static const String BRANCH_AND_BOUND;
+
+				/** Races the strategies given in 
+				 *  \link Option::PORTFOLIO_ALGORITHMS Option::PORTFOLIO_ALGORITHMS \endlink
+				 *  against each other.
+				 *
+				 *  \par
+				 *  If BALL was built with TBB, every strategy runs on its own thread. The strategies 
+				 *  share the penalty of the best solution found so far, which A* and branch and bound
+				 *  use to stop or prune early. As soon as an exact strategy (A*, FPT, ILP) has found
+				 *  its first solution, the remaining strategies are cancelled. The best first solution
+				 *  wins, and further solutions are computed by the winning strategy.
+				 *
+				 *  \par
+				 *  <b>NOTE:</b> FPT is skipped if the options do not allow its use. 
+				 *  Heuristic strategies in the portfolio only provide bounds unless
+				 *  no exact strategy finds a solution. The ILP strategy can neither be
+				 *  cancelled nor pruned, since lp_solve runs to completion: a portfolio
+				 *  containing ILP takes at least as long as ILP alone.
+				 */
+				static const String PORTFOLIO;
 			};
 
 			//@}
@@ -506,6 +539,20 @@ namespace BALL
 			 */
 			bool computeNextSolution(bool apply_solution = true);
 
+			/** Assigns bond orders to many molecules.
+			 *
+			 *  Every molecule is processed as if the processor had been applied to it,
+			 *  using a copy of our options. If BALL was built with TBB and run_parallel
+			 *  is set, the molecules are distributed over a worker pool, each worker
+			 *  owning its own processor. The solutions are not stored in this processor,
+			 *  so set Option::APPLY_FIRST_SOLUTION to keep the results.
+			 *
+			 *  @param  molecules    the molecules to process
+			 *  @param  run_parallel process the molecules concurrently
+			 *  @return Size - the number of molecules for which a solution was found
+			 */
+			Size processBatch(const std::vector<AtomContainer*>& molecules, bool run_parallel = true);
+
 			/** Resets the options to default values.
 			*/
 			void setDefaultOptions();
@@ -540,6 +587,79 @@ namespace BALL
 			 */
 			bool readOptions_();
 
+			/** Checks whether the FPT strategy can be used with the current options.
+			 */
+			bool fptSupportsOptions_();
+
+			/** Returns the strategy for the given algorithm name, or NULL if there is none.
+			 */
+			BondOrderAssignmentStrategy* getStrategy_(const String& algorithm);
+
+			/** Races the strategies of Option::PORTFOLIO_ALGORITHMS and returns the best first solution.
+			 */
+			boost::shared_ptr<BondOrderAssignment> computePortfolioSolution_();
+
+			/** Computes the first solution of a single strategy in a portfolio.
+			 */
+			static boost::shared_ptr<BondOrderAssignment> runPortfolioStrategy_(BondOrderAssignmentStrategy* strategy,
+			                                                                    boost::shared_ptr<BondOrderAssignmentStrategy::SharedBound> bound);
+
+			/** Processes the molecules [begin, end) with a fresh processor using our options.
+			 *  Stores for every molecule the number of solutions found.
+			 */
+			void processBatchRange_(const std::vector<AtomContainer*>& molecules, std::vector<Size>& number_of_solutions,
+			                        Position begin, Position end) const;
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used to race the strategies of a portfolio. */
+			class PortfolioTask_
+			{
+				public:
+					PortfolioTask_(const std::vector<BondOrderAssignmentStrategy*>& strategies,
+					               std::vector<boost::shared_ptr<BondOrderAssignment> >& results,
+					               boost::shared_ptr<BondOrderAssignmentStrategy::SharedBound> bound)
+						: strategies_(strategies),
+							results_(results),
+							bound_(bound)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						for (Position i=r.begin(); i!=r.end(); ++i)
+						{
+							results_[i] = runPortfolioStrategy_(strategies_[i], bound_);
+						}
+					}
+
+				protected:
+					const std::vector<BondOrderAssignmentStrategy*>& strategies_;
+					std::vector<boost::shared_ptr<BondOrderAssignment> >& results_;
+					boost::shared_ptr<BondOrderAssignmentStrategy::SharedBound> bound_;
+			};
+
+			/** A nested class used for the parallel processing of molecule batches. */
+			class BatchTask_
+			{
+				public:
+					BatchTask_(AssignBondOrderProcessor const& prototype, const std::vector<AtomContainer*>& molecules,
+					           std::vector<Size>& number_of_solutions)
+						: prototype_(prototype),
+							molecules_(molecules),
+							number_of_solutions_(number_of_solutions)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						prototype_.processBatchRange_(molecules_, number_of_solutions_, r.begin(), r.end());
+					}
+
+				protected:
+					AssignBondOrderProcessor const& prototype_;
+					const std::vector<AtomContainer*>& molecules_;
+					std::vector<Size>& number_of_solutions_;
+			};
+#endif
+
 
 			/** Reads and stores the penalty-INIFile (for example BondOrder.ini).
 			 *
@@ -779,6 +899,9 @@ namespace BALL
 
 			// The strategies this class can use
 			StringHashMap<boost::shared_ptr<BondOrderAssignmentStrategy> > strategies_;
+
+			// The strategy that won the last portfolio run
+			BondOrderAssignmentStrategy* portfolio_winner_;
 		};
 
 } // namespace BALL 
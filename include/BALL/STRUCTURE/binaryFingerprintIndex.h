@@ -0,0 +1,413 @@
+// -*- Mode: C++; tab-width: 2; -*-
+// vi: set ts=2:
+//
+
+#ifndef BALL_STRUCTURE_BINARYFINGERPRINTINDEX_H
+#define BALL_STRUCTURE_BINARYFINGERPRINTINDEX_H
+
+#ifndef BALL_COMMON_H
+#	include <BALL/common.h>
+#endif
+
+#ifndef BALL_DATATYPE_STRING_H
+#	include <BALL/DATATYPE/string.h>
+#endif
+
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#ifdef BALL_HAS_TBB
+# include <tbb/parallel_for.h>
+# include <tbb/blocked_range.h>
+#endif
+
+namespace boost
+{
+	namespace iostreams
+	{
+		class mapped_file_source;
+	}
+}
+
+namespace BALL
+{
+	/** 	Binary Fingerprint Index
+		\brief A persistent, memory-mapped index for similarity searches in large libraries of 2D binary fingerprints.
+
+		The index is built once by build() and written to a single file. open() maps this file read-only into memory,
+		so that the index is loaded without parsing and all processes which search the same library share one
+		physical copy of it. \n \n
+		The file stores the fingerprints as dense, 64 byte aligned bit rows (the same representation as used by
+		BinaryFingerprintMethods for dense fingerprints), the number of set bits of every fingerprint, and the IDs
+		of the molecules. The rows are sorted by their number of set bits. As the Tanimoto coefficient of two
+		fingerprints with a and b set bits is at most min(a, b) / max(a, b) (Swamidass and Baldi), a threshold
+		search only scans the rows whose bit counts lie in [cutoff * a, a / cutoff], and a top-k search visits
+		the bit counts in order of decreasing bound and stops as soon as no remaining row can enter the result. \n \n
+		Fingerprints are given as feature lists in the format of BinaryFingerprintMethods, i.e. strictly decreasing
+		feature IDs larger than 0 as returned by BinaryFingerprintMethods::parseBinaryFingerprint(). Search results
+		are pairs of the position of a molecule in the library used to build the index and its similarity to the query.
+		If BALL was built with TBB, the rows of a single query or the queries of a batch are scanned in parallel. \n \n
+		Citation:\n
+		Bounds: S.J. Swamidass and P. Baldi, J. Chem. Inf. Model. (2007), 47, 302-317. (doi: 10.1021/ci600358f).
+	 */
+	class BALL_EXPORT BinaryFingerprintIndex
+	{
+		public:
+			/**
+			 * @name Type Definitions
+			 */
+			//@{
+
+			typedef std::vector<std::vector<unsigned short> > FingerprintFeatures;
+
+			/**
+			 * A search result: position of the molecule in the library and its Tanimoto similarity to the query.
+			 */
+			typedef std::pair<Position, float> Hit;
+
+			//@}
+
+			/**
+			 * Number of rows which are scanned as one parallel task.
+			 */
+			static const Size SCAN_CHUNK_SIZE;
+
+			/**
+			 * Alignment (in bytes) of the sections of an index file.
+			 */
+			static const Size PAGE_SIZE;
+
+
+			/**
+			 * @name Constructors and Destructors
+			 */
+			//@{
+
+			/**
+			 * Default constructor. Creates an empty index which has to be opened by open().
+			 */
+			BinaryFingerprintIndex();
+
+
+			/**
+			 * Constructor which maps the given index file.
+			 * @throw Exception::FileNotFound if the file does not exist
+			 * @throw Exception::GeneralException if the file is not a valid index file
+			 */
+			BinaryFingerprintIndex(const String& filename);
+
+
+			/**
+			 * Destructor.
+			 */
+			virtual ~BinaryFingerprintIndex();
+
+			//@}
+
+
+			/**
+			 * @name Index Creation and Mapping
+			 */
+			//@{
+
+			/**
+			 * Build an index for a library of fingerprints and write it to a file.
+			 * @param features Library as lists of integer fingerprint features.
+			 * @param ids IDs of the molecules. Has to be empty or of the same size as features.
+			 * If empty, the positions of the molecules are used as IDs.
+			 * @param filename Name of the index file to be written.
+			 * @throw Exception::GeneralException if the input is invalid or the file cannot be written
+			 */
+			static void build(const FingerprintFeatures& features, const std::vector<String>& ids, const String& filename);
+
+
+			/**
+			 * Map an index file read-only into memory. A previously opened index is closed first.
+			 * @throw Exception::FileNotFound if the file does not exist
+			 * @throw Exception::GeneralException if the file is not a valid index file
+			 */
+			void open(const String& filename);
+
+
+			/**
+			 * Release the mapped index file.
+			 */
+			void close();
+
+
+			/**
+			 * Check if an index file is mapped.
+			 */
+			bool isOpen() const;
+
+			//@}
+
+
+			/**
+			 * @name Accessors
+			 */
+			//@{
+
+			/**
+			 * Get the number of molecules in the index.
+			 */
+			Size getNumberOfMolecules() const;
+
+
+			/**
+			 * Get the number of bits of a fingerprint row, i.e. the largest feature ID in the library plus one.
+			 */
+			Size getNumberOfBits() const;
+
+
+			/**
+			 * Get the ID of a molecule.
+			 * @param index Position of the molecule in the library used to build the index.
+			 * @throw Exception::IndexOverflow if index is not smaller than the number of molecules
+			 */
+			String getID(Position index) const;
+
+
+			/**
+			 * Look up the position of a molecule by its ID.
+			 * @param id ID of the molecule.
+			 * @param index Reference to return the position of the molecule.
+			 * @return True if a molecule with the given ID exists.
+			 */
+			bool findID(const String& id, Position& index) const;
+
+
+			/**
+			 * Get the number of set bits of the fingerprint of a molecule.
+			 * @param index Position of the molecule in the library used to build the index.
+			 * @throw Exception::IndexOverflow if index is not smaller than the number of molecules
+			 */
+			Size getNumberOfSetBits(Position index) const;
+
+
+			/**
+			 * Enable or disable parallel scanning. Ignored if BALL was built without TBB.
+			 */
+			void setRunParallel(bool run_parallel);
+
+
+			/**
+			 * Check if parallel scanning is enabled.
+			 */
+			bool getRunParallel() const;
+
+			//@}
+
+
+			/**
+			 * @name Searching
+			 */
+			//@{
+
+			/**
+			 * Find all molecules with a Tanimoto similarity of at least cutoff to the query.
+			 * @param query Query fingerprint as list of integer features.
+			 * @param cutoff Similarity cutoff. Has to be larger than 0.
+			 * @param hits Vector to return the hits, sorted by decreasing similarity. The vector will be cleaned first.
+			 * @throw Exception::GeneralException if no index is open or the cutoff is invalid
+			 */
+			void thresholdSearch(const std::vector<unsigned short>& query, float cutoff, std::vector<Hit>& hits) const;
+
+
+			/**
+			 * Find all molecules with a Tanimoto similarity of at least cutoff for every query of a batch.
+			 * The queries are distributed over all threads.
+			 * @throw Exception::GeneralException if no index is open or the cutoff is invalid
+			 */
+			void thresholdSearch(const FingerprintFeatures& queries, float cutoff, std::vector<std::vector<Hit> >& hits) const;
+
+
+			/**
+			 * Find the k most similar molecules to the query.
+			 * @param query Query fingerprint as list of integer features.
+			 * @param k Number of molecules to return.
+			 * @param hits Vector to return the hits, sorted by decreasing similarity. The vector will be cleaned first.
+			 * @throw Exception::GeneralException if no index is open
+			 */
+			void topKSearch(const std::vector<unsigned short>& query, Size k, std::vector<Hit>& hits) const;
+
+
+			/**
+			 * Find the k most similar molecules for every query of a batch.
+			 * The queries are distributed over all threads.
+			 * @throw Exception::GeneralException if no index is open
+			 */
+			void topKSearch(const FingerprintFeatures& queries, Size k, std::vector<std::vector<Hit> >& hits) const;
+
+			//@}
+
+		protected:
+
+			/**
+			 * Convert a query into a dense, aligned bit row.
+			 * @param query Query fingerprint as list of integer features.
+			 * @param buffer Storage of the row.
+			 * @param n_set_bits Reference to return the number of features of the query.
+			 * @return Pointer to the aligned row inside buffer.
+			 */
+			const LongSize* encodeQuery_(const std::vector<unsigned short>& query, std::vector<LongSize>& buffer, Size& n_set_bits) const;
+
+
+			/**
+			 * Scan the rows [begin, end) and append all rows with similarity of at least cutoff to hits.
+			 */
+			void scanRows_(const LongSize* query, Size n_set_bits, Position begin, Position end, float cutoff, std::vector<Hit>& hits) const;
+
+
+			/**
+			 * Scan the rows [begin, end), in parallel if enabled and the range is large enough.
+			 */
+			void scanRowsParallel_(const LongSize* query, Size n_set_bits, Position begin, Position end, float cutoff, bool parallel, std::vector<Hit>& hits) const;
+
+
+			/**
+			 * Threshold search for a single query.
+			 */
+			void thresholdSearch_(const std::vector<unsigned short>& query, float cutoff, bool parallel, std::vector<Hit>& hits) const;
+
+
+			/**
+			 * Top-k search for a single query.
+			 */
+			void topKSearch_(const std::vector<unsigned short>& query, Size k, bool parallel, std::vector<Hit>& hits) const;
+
+
+			/**
+			 * Throw an exception if no index is open.
+			 */
+			void checkOpen_(const char* file, int line) const;
+
+#ifdef BALL_HAS_TBB
+			/**
+			 * A nested class used for scanning the rows of a single query in parallel.
+			 */
+			class ScanTask_
+			{
+				public:
+					ScanTask_(BinaryFingerprintIndex const* parent, const LongSize* query, Size n_set_bits,
+					          Position begin, Position end, float cutoff, std::vector<std::vector<Hit> >& chunk_hits)
+						: parent_(parent),
+							query_(query),
+							n_set_bits_(n_set_bits),
+							begin_(begin),
+							end_(end),
+							cutoff_(cutoff),
+							chunk_hits_(chunk_hits)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						for (Position chunk = r.begin(); chunk != r.end(); ++chunk)
+						{
+							Position first = begin_ + chunk * SCAN_CHUNK_SIZE;
+							Position last = std::min(first + SCAN_CHUNK_SIZE, end_);
+							parent_->scanRows_(query_, n_set_bits_, first, last, cutoff_, chunk_hits_[chunk]);
+						}
+					}
+
+				protected:
+					BinaryFingerprintIndex const* parent_;
+					const LongSize* query_;
+					Size n_set_bits_;
+					Position begin_;
+					Position end_;
+					float cutoff_;
+					std::vector<std::vector<Hit> >& chunk_hits_;
+			};
+
+
+			/**
+			 * A nested class used for processing the queries of a batch in parallel.
+			 */
+			class BatchTask_
+			{
+				public:
+					BatchTask_(BinaryFingerprintIndex const* parent, const FingerprintFeatures& queries,
+					           float cutoff, Size k, std::vector<std::vector<Hit> >& hits)
+						: parent_(parent),
+							queries_(queries),
+							cutoff_(cutoff),
+							k_(k),
+							hits_(hits)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						for (Position i = r.begin(); i != r.end(); ++i)
+						{
+							if (k_ > 0)
+							{
+								parent_->topKSearch_(queries_[i], k_, false, hits_[i]);
+							}
+							else
+							{
+								parent_->thresholdSearch_(queries_[i], cutoff_, false, hits_[i]);
+							}
+						}
+					}
+
+				protected:
+					BinaryFingerprintIndex const* parent_;
+					const FingerprintFeatures& queries_;
+					float cutoff_;
+					Size k_;
+					std::vector<std::vector<Hit> >& hits_;
+			};
+#endif
+
+			/// the mapped index file
+			boost::shared_ptr<boost::iostreams::mapped_file_source> mapped_file_;
+
+			/// number of molecules in the index
+			Size number_of_molecules_;
+
+			/// number of bits of a fingerprint row
+			Size number_of_bits_;
+
+			/// number of 64 bit words of a fingerprint row, a multiple of 8
+			Size number_of_words_;
+
+			/// fingerprint rows, sorted by their number of set bits
+			const LongSize* rows_;
+
+			/// number of set bits of every row
+			const Size* row_set_bits_;
+
+			/// position of the molecule of every row in the library
+			const Size* row_molecules_;
+
+			/// rows with i set bits are stored in [set_bit_offsets_[i], set_bit_offsets_[i+1])
+			const Size* set_bit_offsets_;
+
+			/// row of every molecule
+			const Size* molecule_rows_;
+
+			/// start of the ID of every molecule in id_data_, followed by the end of the last ID
+			const LongSize* id_offsets_;
+
+			/// positions of the molecules sorted by their IDs
+			const Size* sorted_ids_;
+
+			/// characters of all IDs
+			const char* id_data_;
+
+			/// scan rows in parallel
+			bool run_parallel_;
+
+		private:
+
+			// an index maps its file read-only, copies are not supported
+			BinaryFingerprintIndex(const BinaryFingerprintIndex&);
+			BinaryFingerprintIndex& operator = (const BinaryFingerprintIndex&);
+	};
+}
+
+#endif // BALL_STRUCTURE_BINARYFINGERPRINTINDEX_H
@@ -128,6 +128,13 @@ namespace BALL
 				 * Intensity level of verbose output
 				 */
 				static const String VERBOSITY;
+				
+				/**
+				 * Average fraction of set bits per fingerprint above which fingerprints are stored as dense bit rows instead of
+				 * inverted indices. Shared feature counts are then calculated by word-wise AND and popcount, which is faster for
+				 * densely populated fingerprints. A value larger than 1.0 disables the dense representation.
+				 */
+				static const String DENSE_THRESHOLD;
 			};
 			
 			/**
@@ -142,6 +149,7 @@ namespace BALL
 				static const bool STORE_NN;
 				static const unsigned int N_THREADS;
 				static const int VERBOSITY;
+				static const float DENSE_THRESHOLD;
 			};
 			
 			
@@ -218,6 +226,25 @@ namespace BALL
 			static bool parseBinaryFingerprint(const String& fprint, std::vector<unsigned short>& features, unsigned int fp_type, const char* delim=",");
 			
 			
+			/**
+			 * Number of set bits in the bitwise AND of two dense fingerprint rows, i.e. the number of shared features.
+			 * The kernel (AVX-512, AVX2, popcnt or scalar popcount) is selected at runtime according to the CPU if BALL is
+			 * compiled with GCC or Clang for x86, otherwise at compile time.
+			 * @param a First row. Has to be 64 byte aligned.
+			 * @param b Second row. Has to be 64 byte aligned.
+			 * @param n_words Number of 64 bit words of both rows. Has to be a multiple of 8.
+			 * @return Number of bits which are set in both rows.
+			 */
+			static unsigned int countCommonBits(const LongSize* a, const LongSize* b, const unsigned int n_words);
+			
+			
+			/**
+			 * Name of the popcount kernel used by countCommonBits().
+			 * @return "avx512", "avx2", "popcnt" or "scalar".
+			 */
+			static String getPopcountKernelName();
+			
+			
 			/** 
 			 * @name Accessors
 			 */
@@ -266,6 +293,14 @@ namespace BALL
 			 */
 			void setVerbosityLevel(const int verbosity);
 			
+			
+			/**
+			 * Check if the dense bit-packed fingerprint representation is used for the current input libraries.
+			 * The representation is selected in setLibraryFeatures() and setQueryFeatures() according to the option DENSE_THRESHOLD.
+			 * @return True if shared feature counts are calculated on dense bit rows.
+			 */
+			bool usesDenseFingerprints() const;
+			
 			//@}
 			
 			
@@ -377,8 +412,17 @@ namespace BALL
 				// Array which stores the ID of the parent cluster to which the molecule at the InvertedIndex position belongs to.
 				unsigned int* parent_clusters;
 				
-				// Array of FeatureLists implemented as a skip list.
+				// Array of FeatureLists implemented as a skip list. Only holds the terminating FeatureList if dense_features is used.
 				FeatureList* feature_skip_list;
+				
+				// Number of 64 bit words of a single dense fingerprint row. 0 if the dense representation is not used.
+				unsigned int n_words;
+				
+				// Dense fingerprints of all molecules stored as consecutive, 64 byte aligned rows of n_words bits. NULL if not used.
+				LongSize* dense_features;
+				
+				// Allocated memory of dense_features including the alignment padding.
+				LongSize* dense_buffer;
 			};
 			
 			
@@ -644,6 +688,18 @@ namespace BALL
 			unsigned int max_clusters_;
 			
 			
+			/**
+			 * Bit density above which the dense fingerprint representation is used.
+			 */
+			float dense_threshold_;
+			
+			
+			/**
+			 * Number of 64 bit words of a dense fingerprint row. 0 if inverted indices are used exclusively.
+			 */
+			unsigned int dense_words_;
+			
+			
 			/**
 			 * Setup routine.
 			 * @param options User defined options to overwrite default settings.
@@ -725,6 +781,14 @@ namespace BALL
 			void setBlockSize(const unsigned short blocksize);
 			
 			
+			/**
+			 * Select the fingerprint representation for the current input libraries.
+			 * The dense representation is used if the average bit density of lib_features_ and query_features_ exceeds dense_threshold_.
+			 * As a side effect, dense_words_ is set appropriately.
+			 */
+			void selectFeatureRepresentation();
+			
+			
 			/**
 			 * Calculates row and column indices for an UPPER TRIANGULAR matrix (includes diagonal) from an index into an 1D array.
 			 * @param row Reference to return the calculated row index of the matrix cell [0, n-1].
@@ -798,6 +862,16 @@ namespace BALL
 			void calculateCommonCounts_M_N(const InvertedIndex* ii_1, const InvertedIndex* ii_2, unsigned short** cc_matrix);
 			
 			
+			/**
+			 * Shared feature count calculation on dense bit rows: InvertedIndices ii1 and ii2 have variable size.
+			 * Both InvertedIndices have to store dense fingerprints of equal row length.
+			 * @param ii1 First InvertedIndex to be compared.
+			 * @param ii2 Second InvertedIndex to be compared.
+			 * @param cc_matrix 2D integer array which finally stores the number of shared features of (ii_1 X ii_2).
+			 */
+			void calculateDenseCommonCounts_M_N(const InvertedIndex* ii_1, const InvertedIndex* ii_2, unsigned short** cc_matrix);
+			
+			
 			/**
 			 * Calculation of similarity coefficients and writing of similarities above cutoff to outfile.
 			 * @param query_index Position of InvertedIndex in query_iindices_.
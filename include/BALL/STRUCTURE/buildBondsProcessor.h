@@ -25,11 +25,26 @@
 	#include <BALL/DATATYPE/options.h>
 #endif
 
+#include <vector>
+
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
 namespace BALL 
 {
 
 	/**	Bond creation processor
 			\ingroup StructureMiscellaneous
+
+			If Option::RUN_PARALLEL is set, the atoms are sorted into a uniform grid whose
+			cells are as large as the longest bond. The grid is cut into slabs along the
+			x axis, and the bond candidates of all slabs are detected concurrently (if BALL
+			was built with TBB), reading the neighbouring slab as a halo region. The distance
+			tests run over contiguous coordinate arrays against a dense table of the bond
+			lengths. The bonds themselves are created afterwards in a single pass, so the
+			\link Composite Composite \endlink tree is never modified concurrently.
 	*/
 	class BALL_EXPORT BuildBondsProcessor 
 		: public UnaryProcessor<AtomContainer> 
@@ -69,6 +84,11 @@ namespace BALL
 				 * 	are deleted, only the shortest bond will stay.
 				 */
 				static const char* DELETE_OVERESTIMATED_BONDS;
+
+				/** If this option is set to true, the bonds are detected by
+				 *  the parallel grid search (see above).
+				 */
+				static const char* RUN_PARALLEL;
 			};
 
 			/// Default values for options
@@ -85,6 +105,9 @@ namespace BALL
 
 				/// this option is off by default
 				static const bool DELETE_OVERESTIMATED_BONDS;
+
+				/// this option is off by default
+				static const bool RUN_PARALLEL;
 			};
 			//@}
 		
@@ -155,6 +178,55 @@ namespace BALL
 		
 			/// builds bonds, based on atom distances read from parameter file using a 3D hash grid
 			Size buildBondsHashGrid3_(AtomContainer& ac);
+
+			/// atoms sorted into the cells of a uniform grid, and the bond length tables
+			struct CellGrid_
+			{
+				Size nx, ny, nz;
+				/// the atoms of cell c are stored at [cell_start[c], cell_start[c+1])
+				std::vector<Position> cell_start;
+				std::vector<Atom*> atoms;
+				std::vector<float> x, y, z;
+				/// row of the atom in the bond length tables (its atomic number)
+				std::vector<Position> element;
+				/// squared maximal and minimal bond lengths, -1 if no bond is possible
+				std::vector<float> max_square_length;
+				std::vector<float> min_square_length;
+				Size table_size;
+			};
+
+			/// builds bonds by the parallel grid search
+			Size buildBondsParallel_(AtomContainer& ac);
+
+			/// collects all pairs of bonded atoms whose first atom lies in the slab x of the grid
+			void findBondsInSlab_(const CellGrid_& grid, Position x, std::vector<std::pair<Atom*, Atom*> >& bonds) const;
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for searching the slabs of the grid in parallel. */
+			class SlabTask_
+			{
+				public:
+					SlabTask_(const BuildBondsProcessor* processor, const CellGrid_& grid,
+					          std::vector<std::vector<std::pair<Atom*, Atom*> > >& bonds)
+						: processor_(processor),
+							grid_(grid),
+							bonds_(bonds)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						for (Position i=r.begin(); i!=r.end(); ++i)
+						{
+							processor_->findBondsInSlab_(grid_, i, bonds_[i]);
+						}
+					}
+
+				protected:
+					const BuildBondsProcessor* processor_;
+					const CellGrid_& grid_;
+					std::vector<std::vector<std::pair<Atom*, Atom*> > >& bonds_;
+			};
+#endif
 		
 			/// after the bonds are built, the orders are estimated
 			void estimateBondOrders_(AtomContainer& ac);
@@ -0,0 +1,256 @@
+// -*- Mode: C++; tab-width: 2; -*-
+// vi: set ts=2:
+//
+
+#ifndef BALL_STRUCTURE_CANONICALHASH_H
+#define BALL_STRUCTURE_CANONICALHASH_H
+
+#ifndef BALL_DATATYPE_STRING_H
+# include <BALL/DATATYPE/string.h>
+#endif
+
+#ifndef BALL_COMMON_HASH_H
+# include <BALL/COMMON/hash.h>
+#endif
+
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
+namespace BALL
+{
+	class Atom;
+	class AtomContainer;
+	class Molecule;
+	class GenericMolFile;
+
+	/** Canonical 128 bit keys of molecular graphs.
+			\ingroup StructureMiscellaneous
+
+			Computes a key of the constitution of a molecule that does not depend on the
+			order of its atoms, e.g. to remove duplicates from a compound library.
+			The atoms are ranked by integer invariants (element, formal charge, number of
+			neighbours), which are refined iteratively by the ranks of the neighbours and
+			the bond orders (Morgan's algorithm). If atoms remain tied, each atom of the
+			lowest tied rank is separated from the others in turn and the ranks are refined
+			again, recursively, until all ranks are distinct. Of all orders found in this
+			way, the one whose sorted list of bonds is smallest is used. Atoms that can be
+			exchanged by a symmetry of the molecule found during the search, or that are
+			bound to the same neighbours, are only tried once. The atom invariants and
+			bonds in this order are folded into two independent 64 bit hashes.
+
+			Only the molecular graph is considered: coordinates and stereo information
+			are ignored, and aromatic and Kekule forms of the same molecule differ, so
+			the molecules should be prepared consistently. Hydrogen bonds are not part of
+			the graph. The key does not depend on the order of the atoms, unless the
+			search has to compare more than 4096 orders; then the best order found so far
+			is used, and different atom orders of the same molecule might give different
+			keys. Equal keys of different molecules are only possible by a collision of
+			both hashes.
+
+			All methods are const and may be called concurrently. computeKeys() hashes
+			batches of molecules in parallel if BALL was built with TBB.
+
+			\code
+				CanonicalHash hasher;
+				std::vector<CanonicalHash::Key> keys;
+				SDFile library("library.sdf");
+				hasher.computeKeys(library, keys);
+
+				HashSet<CanonicalHash::Key> unique_keys;
+				for (Position i = 0; i < keys.size(); ++i)
+				{
+					unique_keys.insert(keys[i]);
+				}
+			\endcode
+	*/
+	class BALL_EXPORT CanonicalHash
+	{
+		public:
+
+			/// A 128 bit key
+			struct BALL_EXPORT Key
+			{
+				Key()
+					: high(0),
+						low(0)
+				{}
+
+				Key(LongSize h, LongSize l)
+					: high(h),
+						low(l)
+				{}
+
+				bool operator == (const Key& key) const { return (high == key.high) && (low == key.low); }
+
+				bool operator != (const Key& key) const { return !(*this == key); }
+
+				bool operator < (const Key& key) const { return (high < key.high) || ((high == key.high) && (low < key.low)); }
+
+				/// Return the key as 32 hexadecimal digits
+				String toString() const;
+
+				LongSize high;
+				LongSize low;
+			};
+
+			/** @name Constructors and Destructors
+			*/
+			//@{
+
+			/// Constructor
+			CanonicalHash(bool ignore_hydrogens = false);
+
+			/// Destructor
+			virtual ~CanonicalHash();
+			//@}
+
+			/** @name Accessors
+			*/
+			//@{
+
+			/// Ignore all hydrogen atoms, e.g. to identify different protonation states
+			void setIgnoreHydrogens(bool ignore_hydrogens) { ignore_hydrogens_ = ignore_hydrogens; }
+
+			///
+			bool getIgnoreHydrogens() const { return ignore_hydrogens_; }
+			//@}
+
+			/** @name Hashing
+			*/
+			//@{
+
+			/// Compute the key of the atoms and bonds of ac
+			Key compute(const AtomContainer& ac) const;
+
+			/** Compute the keys of a batch of molecules.
+			 *  If BALL was built with TBB and run_parallel is set, the molecules are distributed
+			 *  over all available cores.
+			 *  @param keys the key of molecules[i] is stored at keys[i]
+			 */
+			void computeKeys(const std::vector<Molecule*>& molecules, std::vector<Key>& keys, bool run_parallel = true) const;
+
+			/** Compute the keys of all remaining molecules of a file.
+			 *  The molecules are read in blocks of block_size, which are hashed in parallel,
+			 *  and deleted afterwards. The keys are appended to keys in the order of the file.
+			 *  @return the number of molecules read
+			 */
+			Size computeKeys(GenericMolFile& input, std::vector<Key>& keys,
+			                 Size block_size = 1000, bool run_parallel = true) const;
+
+			/** Compute the canonical order of the given atoms.
+			 *  Only the bonds between the given atoms are taken into account, and
+			 *  getIgnoreHydrogens() does not apply.
+			 *  @param rank rank[i] is the position of atoms[i] in the canonical order
+			 */
+			void computeRanking(const std::vector<const Atom*>& atoms, std::vector<Position>& rank) const;
+			//@}
+
+		protected:
+
+			typedef std::vector<std::vector<std::pair<Position, LongSize> > > NeighbourList_;
+
+			/** Replace rank by the dense rank of the pairs (rank[i], values[i]).
+			 *  @return the number of distinct ranks
+			 */
+			static Size rank_(std::vector<Position>& rank, const std::vector<LongSize>& values);
+
+			/** Rank the atoms by their invariants and neighbours, then separate tied atoms
+			 *  until all ranks are distinct.
+			 */
+			static void rankAtoms_(const std::vector<LongSize>& invariants, const NeighbourList_& neighbours,
+			                       std::vector<Position>& rank);
+
+			/// The state of the search for the best order of tied atoms
+			struct SearchState_
+			{
+				/// the ranks with the smallest list of bonds found so far
+				std::vector<Position> best_rank;
+
+				/// the sorted bonds in the order of best_rank
+				std::vector<LongSize> best_certificate;
+
+				/// the atoms separated on the way to best_rank
+				std::vector<Position> best_prefix;
+
+				/// return to this depth of the search, as the branches below are equivalent to known ones
+				Size backtrack_depth;
+
+				/// permutations of the atoms that map the molecule onto itself
+				std::vector<std::vector<Position> > automorphisms;
+
+				/// the number of orders compared so far
+				Size number_of_leaves;
+			};
+
+			/** Separate each atom of the lowest tied rank in turn, refine, and continue
+			 *  recursively until all ranks are distinct.
+			 *  @param prefix the atoms separated on the way to rank
+			 */
+			static void search_(const std::vector<Position>& rank, Size number_of_ranks, std::vector<Position>& prefix,
+			                    const NeighbourList_& neighbours, SearchState_& state);
+
+			/** Refine rank by the ranks of the neighbours until the number of ranks is stable.
+			 *  @return the number of distinct ranks
+			 */
+			static Size refine_(std::vector<Position>& rank, const NeighbourList_& neighbours, Size number_of_ranks);
+
+			/// Hash molecules [begin, end)
+			void computeRange_(const std::vector<Molecule*>& molecules, std::vector<Key>& keys, Position begin, Position end) const;
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for the parallel hashing of molecules. */
+			class HashTask_
+			{
+				public:
+					HashTask_(CanonicalHash const& hasher, const std::vector<Molecule*>& molecules, std::vector<Key>& keys)
+						: hasher_(hasher),
+							molecules_(molecules),
+							keys_(keys)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						hasher_.computeRange_(molecules_, keys_, r.begin(), r.end());
+					}
+
+				protected:
+					CanonicalHash const& hasher_;
+					const std::vector<Molecule*>& molecules_;
+					std::vector<Key>& keys_;
+			};
+#endif
+
+			bool ignore_hydrogens_;
+	};
+
+	/// Hash function for HashSet and HashMap
+	BALL_EXPORT inline HashIndex Hash(const CanonicalHash::Key& key)
+	{
+		return static_cast<HashIndex>(key.low);
+	}
+
+} // namespace BALL
+
+namespace boost
+{
+	template<>
+	struct hash<BALL::CanonicalHash::Key>
+	{
+		size_t operator () (const BALL::CanonicalHash::Key& key) const
+		{
+			size_t hash = 0;
+			boost::hash_combine(hash, key.high);
+			boost::hash_combine(hash, key.low);
+
+			return hash;
+		}
+	};
+}
+
+#endif // BALL_STRUCTURE_CANONICALHASH_H
@@ -106,9 +106,12 @@ namespace BALL
 
 		/**	Creates a FragmentDB object and reads the contents of <tt>filename</tt>.
 		 		If filename is an empty string, the default value "fragments/Fragments.db" is used.
+				@param use_binary_cache read the database from the binary cache if possible (see
+				       \link setUseBinaryCache setUseBinaryCache \endlink)
+				@param binary_cache_filename the binary cache, or an empty string for the default
 				@exception Exception::FileNotFound if the file is not found in the BALL_DATA_PATH
 		*/
-		FragmentDB(const String& filename);
+		FragmentDB(const String& filename, bool use_binary_cache = false, const String& binary_cache_filename = "");
 
 		/**	Copy constructor.
 		*/
@@ -136,6 +139,70 @@ namespace BALL
 		*/
 		void init();
 		
+		//@}
+		/**	@name	Binary cache
+				Parsing the resource files of the database is by far the most expensive part of
+				its construction. Therefore, init() stores a binary snapshot of the parsed
+				database (resource tree, fragments, name maps, and naming standards) and
+				memory-maps it on the next construction instead of parsing the resource files
+				again. The snapshot records the CRC32 checksums of the master file and of all
+				included files and is ignored as soon as one of them changes. A checksum of the
+				snapshot itself guards against truncated or damaged files. The cache is disabled
+				by default, since it writes to the home directory of the user unless another
+				file is set with \link setBinaryCacheFilename setBinaryCacheFilename \endlink.
+				It is enabled either by the constructor, which calls init() immediately, or by
+				\link setUseBinaryCache setUseBinaryCache \endlink before calling init().
+		*/
+		//@{
+
+		/**	Enable or disable the binary cache for subsequent calls of init().
+				The cache is disabled by default.
+		*/
+		void setUseBinaryCache(bool use_cache);
+
+		/**	Return true if init() uses the binary cache.
+		*/
+		bool getUseBinaryCache() const;
+
+		/**	Return true if the last call of init() read the database from the binary cache.
+		*/
+		bool wasLoadedFromBinaryCache() const;
+
+		/**	Set the file used as binary cache.
+				If <tt>filename</tt> is empty, the default returned by 
+				 \link getDefaultBinaryCacheFilename getDefaultBinaryCacheFilename \endlink  is used.
+		*/
+		void setBinaryCacheFilename(const String& filename);
+
+		/**	Return the file used as binary cache by init().
+		*/
+		String getBinaryCacheFilename() const;
+
+		/**	Return the default binary cache for a fragment database file.
+				The cache resides in the home directory of the user and its name is derived
+				from the full path of <tt>db_filename</tt>. If the home directory cannot be
+				determined, an empty string is returned.
+		*/
+		static String getDefaultBinaryCacheFilename(const String& db_filename);
+
+		/**	Store a binary snapshot of the database.
+				The snapshot is written to a temporary file unique to this process, which is
+				then renamed, so that concurrent readers and writers never see a partial file.
+				@return false if the database is invalid or the file could not be written
+		*/
+		bool writeBinaryCache(const String& filename) const;
+
+		/**	Replace the contents of the database by a binary snapshot.
+				The snapshot is only accepted if it was created from the current database
+				file and none of the source files has changed since.
+				@return false if the snapshot is missing, corrupt, or outdated
+		*/
+		bool readBinaryCache(const String& filename);
+
+		/**	Return the resource files the database has been read from.
+		*/
+		const std::vector<String>& getSourceFiles() const;
+
 		//@}
 		/**@name	Inspectors and mutators
 		*/
@@ -563,6 +630,18 @@ namespace BALL
 
 		// Contains the naming standards as a nested map.
 		StringHashMap<NameMap>					standards_;
+
+		// The master file and all included files.
+		std::vector<String>							source_files_;
+
+		// Use the binary cache in init()?
+		bool														use_binary_cache_;
+
+		// The binary cache, or an empty string for the default.
+		String													binary_cache_filename_;
+
+		// Did the last call of init() read the binary cache?
+		bool														loaded_from_binary_cache_;
 	};
   
 } // namespace BALL 
@@ -24,6 +24,11 @@ namespace BALL
 	/** Class to transform bonds with type "aromatic" to 
 	 		conjugated single and double bonds.
 			<br>
+			Every aromatic system is first assigned by a maximum matching (Edmonds'
+			blossom algorithm) on the atoms that need one double bond to become uncharged.
+			Only if this fails, i.e. for systems with charged atoms or without an uncharged
+			Kekule structure, the charges are distributed by the exhaustive search.
+			<br>
 			Useage:<br>
 			\code
 			Kekulizer k;
@@ -102,10 +107,18 @@ namespace BALL
 		///
 		bool useFormalCharges() const { return use_formal_charges_;}
 
+		/// Use the matching for aromatic systems without charges (default: true)
+		void setUseMatching(bool state) { use_matching_ = state;}
+
+		///
+		bool useMatching() const { return use_matching_;}
+
 		protected:
 
 		bool fixAromaticRings_();
 		void fixAromaticSystem_(Position it);
+		// assign the current aromatic system without charges by a perfect matching, if possible
+		bool fixAromaticSystemByMatching_();
 		virtual Size getPenalty_(Atom& atom, Index charge);
 
 		void getMaximumValence_();
@@ -119,6 +132,7 @@ namespace BALL
 		Position calculateDistanceScores_();
 
 		bool use_formal_charges_;
+		bool use_matching_;
 
 		std::vector<std::set<Atom*> > aromatic_systems_;
 		std::vector<std::set<Atom*> > aromatic_rings_;
@@ -25,6 +25,11 @@
 	#include <openbabel/mol.h>
 #endif
 
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
 
 namespace BALL
 {
@@ -32,6 +37,12 @@ namespace BALL
 	{
 		public:
 
+			/** Number of bits of a path fingerprint. */
+			static const Size PATH_FINGERPRINT_BITS;
+
+			/** Number of 64 bit words of a packed path fingerprint. */
+			static const Size PATH_FINGERPRINT_WORDS;
+
 			MolecularSimilarity(String smarts_file);
 
 			void generateFingerprints(System& molecules, vector<vector<Size> >& fingerprints);
@@ -63,6 +74,17 @@ namespace BALL
 
 			void generatePathFingerprint(Molecule& mol, vector<bool>& fingerprint);
 
+			/** Generate path fingerprints for a batch of molecules. \n
+			The fingerprints are identical to those of generatePathFingerprint(), but are written as packed bits into one matrix:
+			bit j of the fingerprint of the i-th molecule is bit (j % 64) of fingerprints[i*PATH_FINGERPRINT_WORDS + j/64].
+			No memory is allocated while enumerating the paths. If BALL was built with TBB and run_parallel is set,
+			the molecules are distributed over all threads. */
+			static void generatePathFingerprints(const list<Molecule*>& molecules, vector<LongSize>& fingerprints, bool run_parallel = true);
+
+			/** Generate path fingerprints for all molecules of a System.
+			@see generatePathFingerprints(const list<Molecule*>&, vector<LongSize>&, bool) */
+			static void generatePathFingerprints(System& molecules, vector<LongSize>& fingerprints, bool run_parallel = true);
+
 			/** Calculate Tanimoto coefficient for two given binary fingerprints. */
 			float calculateSimilarity(vector<bool>& fingerprint1, vector<bool>& fingerprint2);
 
@@ -91,8 +113,32 @@ namespace BALL
 			This function was adapted from OpenBabel (finger2.cpp). */
 			void generatePathHash_(vector<Size>& path, Size& hash);
 
-			bool generatePathFingerprint_(const Atom* atom, std::vector<Size>& path, std::set<const Bond*>& path_bonds, 
-			                              std::vector<bool>& fingerprint);
+			/** Set the bits of all paths starting at the given atom in a packed fingerprint. */
+			static void addAtomPaths_(const Atom& atom, LongSize* fingerprint);
+
+			/** Generate the packed path fingerprints of molecules [begin, end). */
+			static void generatePathFingerprintRange_(const vector<const Molecule*>& molecules, Position begin, Position end, LongSize* fingerprints);
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for the parallel generation of path fingerprints. */
+			class PathFingerprintTask_
+			{
+				public:
+					PathFingerprintTask_(const vector<const Molecule*>& molecules, LongSize* fingerprints)
+						: molecules_(molecules),
+							fingerprints_(fingerprints)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						generatePathFingerprintRange_(molecules_, r.begin(), r.end(), fingerprints_);
+					}
+
+				protected:
+					const vector<const Molecule*>& molecules_;
+					LongSize* fingerprints_;
+			};
+#endif
 
 	};
 }
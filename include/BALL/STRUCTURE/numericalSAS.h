@@ -21,6 +21,13 @@
 #	include <BALL/MATHS/vector3.h>
 #endif
 
+#include <vector>
+
+#ifdef BALL_HAS_TBB
+# include <tbb/parallel_for.h>
+# include <tbb/blocked_range.h>
+#endif
+
 namespace BALL 
 {
 	class Atom;
@@ -38,6 +45,17 @@ namespace BALL
 			for Molecular Systems: Handling of Singularities and Computational Efficiency"
 			J. Comput. Chem. (1993), <b> 14 </b>, 1272-1280).
 
+			The sphere points of each atom are tested against its neighbours in blocks of 64 points,
+			collecting the occlusion of a block in a bit mask, so that the innermost loop over the points
+			can be vectorized by the compiler and a block is finished as soon as all of its points are occluded.
+			If the execution environment is enabled (BALL_HAS_TBB) and the option RUN_PARALLEL is set,
+			the atoms are distributed over all threads.
+
+			The neighbour lists are kept between calls. They are built with an additional margin of
+			NEIGHBOUR_SKIN, and are reused as long as the same atoms with the same radii are used and no
+			atom has moved by more than half of this margin, e.g. for consecutive frames of a trajectory
+			or for several poses of a ligand.
+
 			\ingroup Surface
 			@{
 	*/
@@ -100,6 +118,17 @@ namespace BALL
 				/** The radius of the spherical probe used for the SAS definition.
 				 */
 				static const String PROBE_RADIUS;
+
+				/** The additional margin (in \AA) used when building the neighbour
+				 *  lists. Larger values allow to reuse the lists for larger atom
+				 *  movements between two calls, at the price of more neighbours.
+				 */
+				static const String NEIGHBOUR_SKIN;
+
+				/** This flag decides whether the atoms are processed in parallel
+				 *  (default = true). It is ignored if BALL was built without TBB.
+				 */
+				static const String RUN_PARALLEL;
 			};
 
 			/** Default values for NumericalSAS options.
@@ -143,6 +172,15 @@ namespace BALL
 				 *  definition (1.5 \AA). (@see Option::PROBE_RADIUS)
 				 */
 				static const float PROBE_RADIUS;
+
+				/** Default margin of the neighbour lists (0.5 \AA).
+				 *  (@see Option::NEIGHBOUR_SKIN)
+				 */
+				static const float NEIGHBOUR_SKIN;
+
+				/** Default for parallel execution (true). (@see Option::RUN_PARALLEL)
+				 */
+				static const bool RUN_PARALLEL;
 			};
 			//@}
 
@@ -265,6 +303,16 @@ namespace BALL
 			 * 	disabled through the options.
 			 */
 			const std::vector< std::pair<Vector3, Surface> >& getSurfaceMap() const {return atom_surface_map_;}
+
+			/** Returns true if the last call to operator() reused the neighbour
+			 *  lists of the call before.
+			 */
+			bool hasReusedNeighbours() const {return neighbours_reused_;}
+
+			/** Discards the neighbour lists, so that the next call to operator()
+			 *  builds them anew.
+			 */
+			void clearNeighbours();
 			
 			//@}
 
@@ -281,6 +329,61 @@ namespace BALL
 			 */
 			Size computeSphereTesselation_(TriangulatedSphere& result, int num_points);
 
+			/** Collects the atoms with non-zero radius, their positions, and their
+			 *  SAS radii.
+			 */
+			void collectAtoms_(const AtomContainer& fragment, float probe_radius);
+
+			/** Builds the neighbour lists for the current atoms, unless the lists
+			 *  of the last call can be reused.
+			 *  @return true if the lists have been reused
+			 */
+			bool updateNeighbours_(float skin);
+
+			/** The result of the occlusion test for one atom.
+			 */
+			struct AtomResult_
+			{
+				/// the number of occluded sphere points
+				Size num_occluded;
+
+				/// the sum of the unit vectors of all exposed sphere points
+				Vector3 dr;
+
+				/// one flag per sphere point, only filled if surfaces are requested
+				std::vector<unsigned char> exposed;
+			};
+
+			/** Tests the sphere points of the atoms [begin, end) for occlusion.
+			 */
+			void computeAtomRange_(Position begin, Position end, bool store_exposure, std::vector<AtomResult_>& results) const;
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for the parallel occlusion test.
+			 */
+			class ComputeAtomRangeTask_
+			{
+				public:
+					ComputeAtomRangeTask_(NumericalSAS const* parent, bool store_exposure, std::vector<AtomResult_>& results)
+						: parent_(parent),
+						  store_exposure_(store_exposure),
+						  results_(results)
+					{ }
+
+					void operator() (const tbb::blocked_range<size_t>& r) const
+					{
+						parent_->computeAtomRange_(r.begin(), r.end(), store_exposure_, results_);
+					}
+
+				protected:
+					NumericalSAS const* parent_;
+
+					bool store_exposure_;
+
+					std::vector<AtomResult_>& results_;
+			};
+#endif
+
 			/// the AtomContainer we are bound to
 			AtomContainer const* fragment_;
 
@@ -304,6 +407,35 @@ namespace BALL
 
 			/// vector of (atom center, surface)
 			std::vector< std::pair<Vector3, Surface> > atom_surface_map_;
+
+			/// the atoms with non-zero radius, in the order of iteration
+			std::vector<Atom const*> atoms_;
+
+			/// the positions of atoms_
+			std::vector<Vector3> positions_;
+
+			/// the SAS radii (atom radius + probe radius) of atoms_
+			std::vector<float> radii_;
+
+			/// the unit sphere points, stored coordinate-wise
+			std::vector<float> sphere_x_;
+			std::vector<float> sphere_y_;
+			std::vector<float> sphere_z_;
+
+			/// the atoms, positions, and radii for which the neighbour lists were built
+			std::vector<Atom const*> neighbour_atoms_;
+			std::vector<Vector3> neighbour_positions_;
+			std::vector<float> neighbour_radii_;
+
+			/// the margin used for building the neighbour lists
+			float neighbour_skin_;
+
+			/// the neighbours of atom i are neighbour_indices_[neighbour_offsets_[i]...neighbour_offsets_[i+1]-1]
+			std::vector<Position> neighbour_offsets_;
+			std::vector<Position> neighbour_indices_;
+
+			/// did the last call reuse the neighbour lists?
+			bool neighbours_reused_;
 	};
 
    /** @} */
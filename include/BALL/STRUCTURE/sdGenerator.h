@@ -19,6 +19,15 @@
 
 #include <vector>
 #include <queue>
+#include <map>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
 
 namespace BALL
 {
@@ -68,6 +77,11 @@ namespace BALL
 				 *  diagrams
 				 */
 				static const char* STANDARD_BOND_LENGTH;
+
+				/** reuse the layout of ring systems that have been
+				 *  constructed before (see RingTemplateCache)
+				 */
+				static const char* USE_RING_TEMPLATES;
 			};
 
 			/// Default values for options
@@ -76,8 +90,74 @@ namespace BALL
 				static const bool SHOW_HYDROGENS;
 
 				static const float STANDARD_BOND_LENGTH;
+
+				static const bool USE_RING_TEMPLATES;
 			};
 			//@}
+
+			/**
+			 * A thread-safe cache of ring system layouts.
+			 *
+			 * A layout of a ring system is a layout of every ring system with the same
+			 * graph, so recurring scaffolds only have to be constructed once. The cache maps
+			 * the bonds of a ring system in canonical atom numbering to the relative 2D
+			 * coordinates and the CFS values of its atoms in the same numbering. The same
+			 * scaffold is thus found regardless of the order of its atoms. A cache can be
+			 * shared by several generators, e.g., by the per-thread generators of
+			 * generateSDs(). A cache holding the maximum number of templates is emptied
+			 * before the next template is stored.
+			 */
+			class BALL_EXPORT RingTemplateCache
+			{
+				public:
+
+					/// The layout of a single ring system
+					struct Template
+					{
+						/// positions relative to the first atom of the core ring
+						std::vector<Vector3> positions;
+						std::vector<float> cfs_high;
+						std::vector<float> cfs_low;
+						std::vector<bool> deposited;
+						std::vector<bool> has_cfs;
+					};
+
+					/// The default maximum number of templates
+					static const Size DEFAULT_MAX_SIZE;
+
+					/// @param max_size the maximum number of templates, 0 disables storing templates
+					RingTemplateCache(Size max_size = DEFAULT_MAX_SIZE);
+
+					/** Look up the layout for the given key.
+					 *  @return true if the key has been found
+					 */
+					bool lookup(const String& key, Template& result) const;
+
+					/// Store the layout for the given key
+					void insert(const String& key, const Template& layout);
+
+					/// The number of distinct ring systems in the cache
+					Size getSize() const;
+
+					/// The maximum number of templates
+					Size getMaxSize() const;
+
+					/// The number of successful lookups since construction or the last clear()
+					Size getNumberOfHits() const;
+
+					/// Remove all templates
+					void clear();
+
+				protected:
+
+					mutable boost::mutex mutex_;
+
+					std::map<String, Template> templates_;
+
+					Size max_size_;
+
+					mutable Size hits_;
+			};
 			
 			/** @name Constructors and Destructors.
 			 */
@@ -115,6 +195,25 @@ namespace BALL
       */
       void generateSD(System& molecule_sys);
 
+			/**
+			 * \brief Generates structure diagrams for a batch of systems
+			 *
+			 * If BALL was built with TBB and run_parallel is set, the systems are distributed
+			 * over a worker pool. Each worker uses its own generator with a copy of our options,
+			 * while all of them share our ring template cache. Ring perception is serialized
+			 * internally, the remaining steps run concurrently.
+			 *
+			 * @param systems the systems to lay out; each system must be distinct
+			 * @param run_parallel distribute the systems over all available cores
+			 */
+			void generateSDs(const std::vector<System*>& systems, bool run_parallel = true);
+
+			/// Replace the ring template cache, e.g., to share it between several generators
+			void setRingTemplateCache(boost::shared_ptr<RingTemplateCache> cache);
+
+			/// Return the ring template cache
+			boost::shared_ptr<RingTemplateCache> getRingTemplateCache() const;
+
 		  /**
 			 * Clear all internal data structures.
 			 */
@@ -148,6 +247,43 @@ namespace BALL
 			*/
 			void constructRingSystem_(Position current_ring_system);
 
+			/**
+			* \brief Computes the canonical template key of a ringsystem
+			*
+			* The atoms of the ringsystem are stored in local_atoms in canonical order.
+			* If the system cannot be described by a template, an empty key is returned.
+			*/
+			String computeRingTemplateKey_(std::vector<RingAnalyser::Ring>& current_system,
+			                               std::vector<Position> const& peeling_order, std::vector<Atom*>& local_atoms);
+
+			/// Return the position at which attachCore_ places the first atom of a core ring
+			Vector3 getCoreOrigin_(RingAnalyser::Ring const& core_ring, float x_start);
+
+			/// Lay out the systems [begin, end)
+			void generateSDRange_(const std::vector<System*>& systems, Position begin, Position end);
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for the parallel generation of structure diagrams. */
+			class SDTask_
+			{
+				public:
+					SDTask_(SDGenerator const& prototype, const std::vector<System*>& systems)
+						: prototype_(prototype),
+							systems_(systems)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						SDGenerator generator(prototype_);
+						generator.generateSDRange_(systems_, r.begin(), r.end());
+					}
+
+				protected:
+					SDGenerator const& prototype_;
+					const std::vector<System*>& systems_;
+			};
+#endif
+
 			// Obtain the CFS from the properties of the atom...
 			Angle getCFS_(Atom const* atom, bool hi);
 
@@ -268,6 +404,9 @@ namespace BALL
 
 			/// the system we are working on
 			System* system_;
+
+			/// the ring template cache, possibly shared with other generators
+			boost::shared_ptr<RingTemplateCache> ring_template_cache_;
 	};
 
 } // namepspace BALL
@@ -52,6 +52,21 @@ namespace BALL
 		virtual Processor::Result operator() (Composite& composite);
 		//@}
 
+		/**	@name Assignment from H-bond patterns */
+		//@{
+
+		/** Compute the DSSP summary for a precomputed backbone H-bond pattern.
+				The pattern has the layout returned by HBondProcessor::getBackboneHBondPattern():
+				entry i lists the residues whose N-H donates an H-bond to the C=O of residue i.
+				No composite is modified.
+				@return one character per residue (H, G, I, E, B, T or -)
+		*/
+		const String& computeSummary(const std::vector<std::vector<Position> >& hbond_pattern);
+
+		/// Return the summary computed by the last call
+		const String& getSummary() const { return summary_; }
+		//@}
+
 		protected:
 
 		/// Compute the secondary structure
@@ -0,0 +1,269 @@
+// -*- Mode: C++; tab-width: 2; -*-
+// vi: set ts=2:
+//
+
+#ifndef BALL_STRUCTURE_SECONDARYSTRUCTURETIMELINE_H
+#define BALL_STRUCTURE_SECONDARYSTRUCTURETIMELINE_H
+
+#ifndef BALL_DATATYPE_OPTIONS_H
+# include <BALL/DATATYPE/options.h>
+#endif
+
+#ifndef BALL_MATHS_VECTOR3_H
+# include <BALL/MATHS/vector3.h>
+#endif
+
+#ifndef BALL_STRUCTURE_SECONDARYSTRUCTUREPROCESSOR_H
+# include <BALL/STRUCTURE/secondaryStructureProcessor.h>
+#endif
+
+#include <vector>
+#include <iostream>
+
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
+namespace BALL
+{
+	class System;
+	class Residue;
+	class SnapShot;
+	class TrajectoryFile;
+
+	/** Secondary structure timeline of a trajectory.
+	 		\ingroup StructureMiscellaneous
+
+			Assigns the DSSP secondary structure (see SecondaryStructureProcessor) to every
+			frame of a trajectory and stores the result as a compact matrix with one
+			character (H, G, I, E, B, T or -) per residue and frame.
+
+			setup() extracts the backbone atoms N, C and O of all residues in the chains
+			of the system once. For every frame, only these atoms are read from the
+			SnapShot into a backbone coordinate array, the amide hydrogens are placed as in
+			HBondProcessor, and the Kabsch-Sander H-bonds are detected with a uniform cell
+			grid over the N atoms. Grid, coordinate array and H-bond pattern buffers are
+			reused for all frames handled by the same worker. As in SecondaryStructureProcessor,
+			every chain is assigned separately.
+
+			Frames are read from the trajectory in blocks of Option::BLOCK_SIZE snapshots;
+			the frames of a block are processed in parallel if BALL was built with TBB.
+			The system itself is never modified.
+
+			\code
+				SecondaryStructureTimeline timeline;
+				timeline.setup(system);
+
+				DCDFile dcd("md.dcd");
+				timeline.compute(dcd);
+
+				for (Position i = 0; i < timeline.getNumberOfResidues(); ++i)
+				{
+					std::cout << timeline.getResidueTimeline(i) << std::endl;
+				}
+			\endcode
+	*/
+	class BALL_EXPORT SecondaryStructureTimeline
+	{
+		public:
+
+			/** @name Constant Definitions
+			*/
+			//@{
+			/// Option names
+			struct BALL_EXPORT Option
+			{
+				/** The energy cutoff of the Kabsch-Sander H-bond criterion (kcal/mol).
+				 */
+				static const char* ENERGY_CUTOFF;
+
+				/** Number of snapshots read from a trajectory before they are processed.
+				 */
+				static const char* BLOCK_SIZE;
+
+				/** Process the frames of a block in parallel.
+				 */
+				static const char* RUN_PARALLEL;
+			};
+
+			/// Default values for options
+			struct BALL_EXPORT Default
+			{
+				static const float ENERGY_CUTOFF;
+				static const Size  BLOCK_SIZE;
+				static const bool  RUN_PARALLEL;
+			};
+			//@}
+
+			/** @name	Constructors and Destructors
+			*/
+			//@{
+
+			/// Default constructor
+			SecondaryStructureTimeline();
+
+			/// Copy constructor
+			SecondaryStructureTimeline(const SecondaryStructureTimeline& timeline);
+
+			/// Destructor
+			virtual ~SecondaryStructureTimeline();
+
+			/// Assignment operator
+			SecondaryStructureTimeline& operator = (const SecondaryStructureTimeline& timeline);
+
+			/// Clears the backbone and all frames. The options remain.
+			void clear();
+			//@}
+
+			/**	@name	Setup and Computation
+			*/
+			//@{
+
+			/// Resets the options to default values.
+			void setDefaultOptions();
+
+			/** Extract the backbone of all residues in the chains of system.
+			 *  The system must have the atom order of the snapshots that will be processed.
+			 *  All frames computed so far are removed.
+			 *  @return false if the system does not contain any residue
+			 */
+			bool setup(const System& system);
+
+			/** Append all remaining snapshots of a trajectory.
+			 *  @return false if setup() was not called or a snapshot does not match the system
+			 */
+			bool compute(TrajectoryFile& trajectory);
+
+			/** Append the given snapshots.
+			 *  @return false if setup() was not called or a snapshot does not match the system
+			 */
+			bool compute(const std::vector<SnapShot>& snapshots);
+			//@}
+
+			/**	@name	Accessors
+			*/
+			//@{
+
+			/// Return the number of frames computed so far
+			Size getNumberOfFrames() const { return number_of_frames_; }
+
+			/// Return the number of residues of the timeline
+			Size getNumberOfResidues() const { return residues_.size(); }
+
+			/// Return the residue belonging to the given row of the timeline
+			const Residue* getResidue(Position residue) const;
+
+			/// Return the secondary structure of a residue in a frame
+			char getType(Position frame, Position residue) const
+			{
+				return timeline_[frame * residues_.size() + residue];
+			}
+
+			/// Return the secondary structure of all residues in a frame
+			String getFrame(Position frame) const;
+
+			/// Return the secondary structure of a residue over all frames
+			String getResidueTimeline(Position residue) const;
+
+			/// Return the fraction of frames in which a residue was assigned the given type
+			float getFraction(Position residue, char type) const;
+
+			/** Return the whole timeline.
+			 *  Frames are stored one after another, each with one character per residue.
+			 */
+			const std::vector<char>& getTimeline() const { return timeline_; }
+
+			/** Write the timeline, one line per residue.
+			 *  Each line holds the residue name and id, followed by the types of all frames.
+			 */
+			void write(std::ostream& out) const;
+			//@}
+
+			/** @name Public Attributes
+			*/
+			//@{
+			/// options
+			Options options;
+			//@}
+
+		protected:
+
+			/// The backbone atoms of a residue, given as indices into the snapshot coordinates
+			struct Residue_
+			{
+				const Residue* residue;
+				Position       N;
+				Position       C;
+				Position       O;
+				// index of the chain and the position of the residue in it
+				Position       chain;
+				Position       number;
+				// N, C and O were found
+				bool           is_complete;
+				// the amide hydrogen can be placed from the previous residue
+				bool           has_H;
+			};
+
+			/// Buffers of a worker, reused for all frames it processes
+			struct Workspace_
+			{
+				// N, C, O and H of every residue
+				std::vector<Vector3>                              backbone;
+				// the cell grid over the N atoms
+				std::vector<Position>                             cell_of;
+				std::vector<Position>                             cell_start;
+				std::vector<Position>                             cell_index;
+				// the H-bond pattern of each chain
+				std::vector<std::vector<std::vector<Position> > > patterns;
+				SecondaryStructureProcessor                       processor;
+			};
+
+			/// Process the snapshots [begin, end) of the current block
+			void computeFrames_(Position begin, Position end);
+
+			/// Assign the secondary structure of a single snapshot to the given frame
+			void computeFrame_(const SnapShot& snapshot, Position frame, Workspace_& workspace);
+
+			/// Detect the backbone H-bonds of the coordinates in workspace.backbone
+			void computeHBonds_(Workspace_& workspace) const;
+
+			/// Append the first n snapshots of the given array
+			void computeBlock_(const SnapShot* snapshots, Size n);
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for the parallel processing of the frames of a block. */
+			class FrameTask_
+			{
+				public:
+					FrameTask_(SecondaryStructureTimeline* timeline)
+						: timeline_(timeline)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						timeline_->computeFrames_(r.begin(), r.end());
+					}
+
+				protected:
+					SecondaryStructureTimeline* timeline_;
+			};
+#endif
+
+			std::vector<Residue_> residues_;
+			// the first residue of each chain, followed by the number of residues
+			std::vector<Position> chain_start_;
+			Size                  number_of_atoms_;
+
+			// the block currently processed
+			const SnapShot*       block_;
+			Position              first_frame_;
+			float                 energy_cutoff_;
+
+			std::vector<char>     timeline_;
+			Size                  number_of_frames_;
+	};
+
+} // namespace BALL
+
+#endif // BALL_STRUCTURE_SECONDARYSTRUCTURETIMELINE_H
@@ -0,0 +1,301 @@
+// -*- Mode: C++; tab-width: 2; -*-
+// vi: set ts=2:
+//
+
+#ifndef BALL_STRUCTURE_SIDECHAINPACKER_H
+#define BALL_STRUCTURE_SIDECHAINPACKER_H
+
+#ifndef BALL_DATATYPE_OPTIONS_H
+# include <BALL/DATATYPE/options.h>
+#endif
+
+#ifndef BALL_MATHS_VECTOR3_H
+# include <BALL/MATHS/vector3.h>
+#endif
+
+#ifndef BALL_STRUCTURE_RESIDUEROTAMERSET_H
+# include <BALL/STRUCTURE/residueRotamerSet.h>
+#endif
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#ifdef BALL_HAS_TBB
+	#include <tbb/parallel_for.h>
+	#include <tbb/blocked_range.h>
+#endif
+
+namespace BALL
+{
+	class AtomContainer;
+	class Residue;
+	class RotamerLibrary;
+
+	/** Native side chain packer.
+	 		\ingroup StructureMiscellaneous
+
+			Places the side chains of a set of residues on a fixed backbone by
+			choosing one rotamer per residue from a RotamerLibrary.
+
+			The energy of a packing consists of a self energy per rotamer (the library
+			probability, -w log(p/p_max), plus the steric repulsion against all fixed atoms)
+			and a pair energy between rotamers of neighbouring residues. Steric repulsion
+			is a piecewise linear function of the scaled van der Waals radii of the heavy atoms.
+
+			All pair energies are tabulated up front (in parallel if BALL was built with TBB).
+			Goldstein dead-end elimination then discards rotamers that can never be part of
+			the optimum. The residues that still have more than one rotamer left form an
+			interaction graph; every connected component of this graph is solved exactly by
+			variable elimination along a fill-in minimizing elimination order, i.e., along a
+			tree decomposition of the component. Components whose tables would exceed
+			Option::MAX_TABLE_SIZE are optimized by iterated conditional modes instead.
+
+			\code
+				SideChainPacker packer;
+
+				std::vector<Residue*> residues;
+				for (ResidueIterator it = system.beginResidue(); +it; ++it)
+				{
+					residues.push_back(&*it);
+				}
+				packer.pack(system, residues);
+			\endcode
+	*/
+	class BALL_EXPORT SideChainPacker
+	{
+		public:
+
+			/** @name Constant Definitions
+			*/
+			//@{
+			/// Option names
+			struct BALL_EXPORT Option
+			{
+				/** Weight of the rotamer probability term -log(p/p_max).
+				 */
+				static const char* PROBABILITY_WEIGHT;
+
+				/** Scaling factor applied to the van der Waals radii in the repulsion term.
+				 */
+				static const char* RADIUS_SCALING;
+
+				/** Rotamers with a library probability below this value are not considered.
+				 *  The most probable rotamer of a residue is always kept.
+				 */
+				static const char* PROBABILITY_CUTOFF;
+
+				/** Maximum number of entries of a single table during variable elimination.
+				 */
+				static const char* MAX_TABLE_SIZE;
+
+				/** Compute the pair energy tables in parallel.
+				 */
+				static const char* RUN_PARALLEL;
+			};
+
+			/// Default values for options
+			struct BALL_EXPORT Default
+			{
+				static const float PROBABILITY_WEIGHT;
+				static const float RADIUS_SCALING;
+				static const float PROBABILITY_CUTOFF;
+				static const Size  MAX_TABLE_SIZE;
+				static const bool  RUN_PARALLEL;
+			};
+			//@}
+
+			/** @name	Constructors and Destructors
+			*/
+			//@{
+
+			/** Default constructor.
+			 *  The default rotamer library is loaded on first use.
+			 */
+			SideChainPacker();
+
+			/// Constructor using the given rotamer library. The library is not copied.
+			SideChainPacker(RotamerLibrary& library);
+
+			/// Copy constructor. The rotamer library is shared.
+			SideChainPacker(const SideChainPacker& packer);
+
+			/// Destructor
+			virtual ~SideChainPacker();
+
+			/// Assignment operator
+			SideChainPacker& operator = (const SideChainPacker& packer);
+
+			/// Clears the results of the last packing. The options remain.
+			void clear();
+			//@}
+
+			/**	@name	Accessors
+			*/
+			//@{
+
+			/// Resets the options to default values.
+			void setDefaultOptions();
+
+			/// Use the given rotamer library. The library is not copied.
+			void setRotamerLibrary(RotamerLibrary& library);
+
+			/// Return the rotamer library, or 0 if none has been loaded yet.
+			RotamerLibrary* getRotamerLibrary() const;
+
+			/// Return the energy of the last packing
+			double getEnergy() const { return energy_; }
+
+			/// Return the number of residues that were packed in the last run
+			Size getNumberOfPositions() const { return positions_.size(); }
+
+			/// Return the number of rotamers considered in the last run
+			Size getNumberOfRotamers() const;
+
+			/// Return the number of rotamers removed by dead-end elimination in the last run
+			Size getNumberOfEliminatedRotamers() const { return number_of_eliminated_rotamers_; }
+
+			/// Return the largest width of the elimination orders used in the last run
+			Size getTreeWidth() const { return tree_width_; }
+
+			/// Return the number of components that had to be optimized heuristically in the last run
+			Size getNumberOfApproximatedComponents() const { return number_of_approximated_components_; }
+			//@}
+
+			/**	@name	Packing
+			*/
+			//@{
+
+			/** Place the side chains of the given residues.
+			 *
+			 *  All atoms of ac that do not belong to the side chains of these residues are kept
+			 *  fixed and define the environment. Residues without rotamers in the library (e.g.,
+			 *  GLY or ALA) are silently kept as they are.
+			 *
+			 *  @param ac       the atom container holding the residues and their environment
+			 *  @param residues the residues whose side chains should be placed
+			 *  @return false if no rotamer library could be loaded
+			 */
+			bool pack(AtomContainer& ac, const std::vector<Residue*>& residues);
+			//@}
+
+			/** @name Public Attributes
+			*/
+			//@{
+			/// options
+			Options options;
+			//@}
+
+		protected:
+
+			/// A residue whose side chain is placed
+			struct Position_
+			{
+				Residue*                          residue;
+				ResidueRotamerSet*                rotamer_set;
+				std::vector<Rotamer>              rotamers;
+				// heavy side chain atom coordinates for each rotamer
+				std::vector<std::vector<Vector3> > coordinates;
+				std::vector<float>                radii;
+				std::vector<double>               self_energies;
+				std::vector<bool>                 alive;
+				Vector3                           center;
+				float                             reach;
+				Index                             assignment;
+			};
+
+			/// Pair energies between the rotamers of two neighbouring positions (first < second)
+			struct PairTable_
+			{
+				Position            first;
+				Position            second;
+				std::vector<double> energies;
+			};
+
+			/// A table created while eliminating a variable
+			struct Factor_
+			{
+				std::vector<Position> scope;
+				std::vector<double>   values;
+			};
+
+			/// Records the optimal value of an eliminated variable for each assignment of its neighbours
+			struct Bucket_
+			{
+				Position              variable;
+				std::vector<Position> scope;
+				std::vector<Position> argmin;
+			};
+
+			/// Compute the rotamer coordinates of a position. Returns false if no rotamer could be set.
+			bool setupPosition_(Position_& position);
+
+			/// Compute the self energies of all positions against the fixed atoms of ac
+			void computeSelfEnergies_(AtomContainer& ac);
+
+			/// Compute the pair energy table with the given index
+			void computePairTable_(Position index);
+
+			/// Steric repulsion between two atoms with the given (scaled) radii
+			double repulsion_(double distance, double radius_sum) const;
+
+			/// Return the pair energy of rotamer a at pair.first and rotamer b at pair.second
+			double getPairEnergy_(const PairTable_& pair, Position a, Position b) const
+			{
+				return pair.energies[a * positions_[pair.second].rotamers.size() + b];
+			}
+
+			/// Goldstein singles dead-end elimination
+			void eliminateDeadEnds_();
+
+			/// Solve a connected component of the interaction graph by variable elimination
+			bool solveComponent_(const std::vector<Position>& component, std::vector<std::vector<Position> >& domains,
+			                     std::vector<std::vector<double> >& unary);
+
+			/// Optimize a connected component by iterated conditional modes
+			void approximateComponent_(const std::vector<Position>& component, std::vector<std::vector<Position> >& domains,
+			                           std::vector<std::vector<double> >& unary);
+
+			/// Compute the energy of the current assignment
+			double computeEnergy_() const;
+
+#ifdef BALL_HAS_TBB
+			/** A nested class used for the parallel computation of the pair energy tables. */
+			class PairEnergyTask_
+			{
+				public:
+					PairEnergyTask_(SideChainPacker* packer)
+						: packer_(packer)
+					{}
+
+					void operator() (const tbb::blocked_range<Position>& r) const
+					{
+						for (Position i=r.begin(); i!=r.end(); ++i)
+						{
+							packer_->computePairTable_(i);
+						}
+					}
+
+				protected:
+					SideChainPacker* packer_;
+			};
+#endif
+
+			RotamerLibrary*                   library_;
+			boost::shared_ptr<RotamerLibrary> own_library_;
+
+			std::vector<Position_>   positions_;
+			std::vector<PairTable_>  pairs_;
+			// for each position the indices of its pair tables
+			std::vector<std::vector<Position> > neighbours_;
+
+			float  radius_scaling_;
+			double energy_;
+			Size   number_of_eliminated_rotamers_;
+			Size   tree_width_;
+			Size   number_of_approximated_components_;
+	};
+
+} // namespace BALL
+
+#endif // BALL_STRUCTURE_SIDECHAINPACKER_H
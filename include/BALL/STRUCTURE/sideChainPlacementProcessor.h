@@ -13,6 +13,10 @@
 # include <BALL/DATATYPE/options.h>
 #endif
 
+#ifndef BALL_STRUCTURE_SIDECHAINPACKER_H
+# include <BALL/STRUCTURE/sideChainPacker.h>
+#endif
+
 namespace BALL 
 {
 	/**	Side Chain Placement Processor
@@ -23,6 +27,8 @@ namespace BALL
 	 * 
 	 *  Given the path to the SCWRL binary in the option Option::SCWRL_BINARY_PATH;
 	 *  the processor computes side chain conformations for the given side chains. 
+	 *  With Option::METHOD set to Method::NATIVE, the side chains are placed in-process
+	 *  by a \link SideChainPacker SideChainPacker \endlink instead and no external binary is needed.
 	 *  If no selection is given all side chains are considered.
 	 *  The option Option::MUTATE_SELECTED_SIDE_CHAINS can be used to mutate selected
 	 *  amino acids as specified in the member mutated_sequence_.
@@ -112,6 +118,11 @@ namespace BALL
 				 * SCWRL4 is a program for predicting side-chain conformations for a given protein backbone.
 				 */
 				static const String SCWRL_4_0;
+
+				/**
+				 * The built-in SideChainPacker using the BALL rotamer library.
+				 */
+				static const String NATIVE;
 				//static const String SCWRL_SERVER; 
 				//static const String ILP;
 			};
@@ -188,6 +199,14 @@ namespace BALL
 			 */
 			String getMutations() {return mutated_sequence_;}
 
+			/** Get the packer used by Method::NATIVE, e.g., to change its options or rotamer library.
+			 */
+			SideChainPacker& getSideChainPacker() {return packer_;}
+
+			/** Get the packer used by Method::NATIVE.
+			 */
+			const SideChainPacker& getSideChainPacker() const {return packer_;}
+
 			//@}
 			/** @name Assignment
 			*/
@@ -213,6 +232,9 @@ namespace BALL
 			 * @return bool - true otherwise
 			 */
 			bool readOptions_(); 
+
+			/// Place (and mutate) the side chains of ac with the native packer
+			Processor::Result applyNative_(AtomContainer& ac);
 		
 			/// Sequence in OneLetterCode with mutated residues.
 			String mutated_sequence_;	
@@ -220,6 +242,9 @@ namespace BALL
 			// The processor state. 
 			bool valid_;
 
+			/// The packer used by Method::NATIVE
+			SideChainPacker packer_;
+
 	};
 
 } // namespace BALL 
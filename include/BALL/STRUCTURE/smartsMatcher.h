@@ -9,9 +9,14 @@
 # include <BALL/STRUCTURE/smartsParser.h>
 #endif
 
+#ifndef BALL_DATATYPE_HASHMAP_H
+# include <BALL/DATATYPE/hashMap.h>
+#endif
+
 #include <vector>
 #include <set>
 #include <map>
+#include <bitset>
 
 #include <boost/shared_ptr.hpp>
 
@@ -39,6 +44,18 @@ namespace BALL
 			Warning, the SSSR should always be up-to-date, i.e. the SSSR of the 
 			current molecule, otherwise the matcher might report wrong results.
 
+			SMARTS patterns are parsed only once. The compiled patterns are kept in 
+			a cache shared by all matchers (see clearQueryCache()), which is cleared 
+			when it holds \link MAX_QUERY_CACHE_SIZE MAX_QUERY_CACHE_SIZE \endlink patterns. When several 
+			patterns are matched at once, the SSSR is computed only once, patterns 
+			requiring elements or ring atoms the molecule does not have are skipped 
+			without matching, and the results of equal atom predicates are shared 
+			between the patterns.
+
+			Different threads may match concurrently, as long as each thread uses 
+			its own SmartsMatcher and the compiler supports thread local storage 
+			(BALL_HAS_THREAD_LOCAL). Otherwise, the matcher is not reentrant.
+
 			\ingroup StructureMatching
 	*/
 	class BALL_EXPORT SmartsMatcher
@@ -51,6 +68,13 @@ namespace BALL
 			typedef std::vector<std::set<const Atom*> > Match;
 			//@}
 
+			/** @name Constants
+			*/
+			//@{
+			/// the maximum number of compiled patterns kept in the cache
+			static const Size MAX_QUERY_CACHE_SIZE;
+			//@}
+
 
 			/**	@name Constructors and Destructors
 			*/
@@ -83,6 +107,20 @@ namespace BALL
 
 			/// this function is used to cause the matcher to do an ring perception if needed (do not use the set SSSR any more)
 			void unsetSSSR();
+
+			/// returns the number of patterns the last match of several patterns skipped without matching
+			Size getNumberOfSkippedPatterns() const;
+			//@}
+
+
+			/** @name Compiled patterns
+			*/
+			//@{
+			/// removes all compiled SMARTS patterns and their predicate ids from the cache shared by all matchers
+			static void clearQueryCache();
+
+			/// returns the number of compiled SMARTS patterns in the cache
+			static Size getQueryCacheSize();
 			//@}
 
 
@@ -248,8 +286,45 @@ namespace BALL
 					Position pos_;
 			};
 
-			/// the pool of rec struct objects
-			static boost::shared_ptr<RecStructPool_> pool_;
+			/// a parsed SMARTS pattern with the information used for prefiltering molecules
+			struct CompiledQuery_
+			{
+				/// the parser holding the pattern tree
+				boost::shared_ptr<SmartsParser> parser;
+
+				/// atomic numbers of the elements every match contains
+				std::bitset<128> required_elements;
+
+				/// true if every match contains a ring atom
+				bool requires_ring_atom;
+
+				/// the ids of the atom predicates, equal for equal predicates of different patterns
+				std::map<const SPAtom*, Position> predicate_ids;
+
+				/// the number of times the cache was cleared before the pattern was compiled
+				Size generation;
+			};
+
+			/// the compiled patterns shared by all matchers
+			static std::map<String, boost::shared_ptr<CompiledQuery_> > query_cache_;
+
+			/// removes all compiled patterns and predicate ids, the caller must hold the cache lock
+			static void clearQueryCache_();
+
+			/// returns the compiled pattern from the cache, parsing it if needed
+			static boost::shared_ptr<CompiledQuery_> getCompiledQuery_(const String& smarts);
+
+			/// collects the elements and ring atoms required by the subtree of the given node
+			static void collectRequirements_(SPNode* node, CompiledQuery_& query);
+
+			/// returns the pool of rec struct objects of the calling thread
+			static RecStructPool_& getPool_();
+
+			/// matches a compiled pattern
+			void match_(Match& matches, Molecule& mol, const CompiledQuery_& query, const String& smarts, const std::set<const Atom*>& start_atoms);
+
+			/// evaluates the atom predicate of the node, using the shared predicate results if available
+			bool evaluateAtom_(const SPNode* node, const Atom* atom);
 
 			/// method for evaluation of ring edges, after the the smarts tree is matched to molcule
 			bool evaluateRingEdges_(const std::set<const Atom*>& matching, const std::map<const SPNode*, const Atom*>& mapping, const String& smarts);
@@ -274,6 +349,18 @@ namespace BALL
 
 			// debug output depth
 			Size depth_;
+
+			/// the pattern currently matched
+			const CompiledQuery_* current_query_;
+
+			/// indices of the atoms of the molecule, only set if predicate results are shared
+			HashMap<const Atom*, Position> atom_indices_;
+
+			/// the results of the atom predicates (-1 if not evaluated yet), indexed by predicate id and atom
+			std::vector<std::vector<signed char> > predicate_results_;
+
+			/// the number of patterns skipped by the last match of several patterns
+			Size skipped_patterns_;
 	};
   
 } // namespace BALL
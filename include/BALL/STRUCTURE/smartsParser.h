@@ -342,6 +342,14 @@ namespace BALL
 				/// returns true if the property is set
 				bool hasProperty(PropertyType type) const;
 
+				/// returns true if the property is negated
+				bool isNotProperty(PropertyType type) const;
+
+				/** returns a key describing all properties of this SPAtom. SPAtoms with
+						equal keys match the same atoms.
+				*/
+				String getPropertyKey() const;
+
 				/// returns a value of the given property type
 				PropertyValue getProperty(PropertyType type);
 
@@ -675,7 +683,9 @@ namespace BALL
 		/// returns the ring connections sorted by index from SMARTS pattern
 		std::map<Size, std::vector<SPNode*> > getRingConnections() const;
 	
-		/// sets the SSSR
+		/** sets the SSSR used for matching ring properties. The SSSR is stored
+				per thread, so that different molecules can be matched concurrently.
+		*/
 		void setSSSR(const std::vector<std::vector<Atom*> >& sssr);
 
 		/// sets the sssr needed flag
@@ -740,9 +750,6 @@ namespace BALL
 			/// component level grouping flag
 			bool component_grouping_;
 
-			/// the sssr 
-			static vector<std::set<const Atom*> >* sssr_;
-
 			/// dump method for the tree
 			void dumpTreeRecursive_(SPNode* node, Size depth);
 
@@ -43,6 +43,35 @@ namespace BALL
 {
 
 	/** SurfaceProcessor.
+			Computes the solvent excluded or solvent accessible surface of all atoms the
+			processor is applied to.
+
+			If incremental updates are enabled (setIncremental()), the processor keeps the
+			spheres of the last computation and assigns each triangle to the sphere it belongs to.
+			When it is applied again to the same number of atoms of which only a few have moved,
+			only the spheres within the influence region of the moved ones (i.e. those that can
+			touch a common probe with a moved sphere) are recomputed, together with a shell of
+			surrounding spheres that shields the region from the rest of the structure. The
+			triangles of the recomputed region then replace the old ones, while all other triangles
+			are kept as they are. Along the seam, coinciding vertices are merged, and the places
+			where kept and recomputed triangles do not fit are cut out and triangulated anew (see
+			stitchSeams_()). If the patched surface is still not closed (i.e. some edge is not
+			shared by exactly two triangles), the update is discarded and the whole surface is
+			recomputed instead; wasUpdatedIncrementally() tells which path was taken.
+
+			For large assemblies, the computation can be decomposed spatially (setBlockSize()).
+			The spheres are then distributed over cubic blocks, and the surface of each block is
+			computed from its own spheres and all spheres within the influence distance around it.
+			Each patch is trimmed to the triangles belonging to the block's own spheres. The
+			patches are then stitched: coinciding vertices are merged, and the places where
+			neighbouring patches do not fit are cut out and triangulated anew (see stitchSeams_()).
+			If the stitched surface is not closed, the whole surface is computed instead;
+			wasDecomposed() tells which path was taken. The reduced and solvent excluded surfaces
+			only exist for the block currently processed, so their memory is bounded by the block
+			size. The blocks are computed one after another, since the surface classes temporarily
+			change the global Constants::EPSILON. As the blocks overlap by the influence distance,
+			the decomposition takes several times longer than computing the whole surface at once;
+			it pays off when the whole surface does not fit into memory.
 	\ingroup Surface			
 	*/
 	class BALL_EXPORT SurfaceProcessor
@@ -125,10 +154,130 @@ namespace BALL
 
 		/// Get the surface type to be computed.
 		SurfaceType getType() const  { return surface_type_; }
+
+		/** Enable or disable incremental updates of the surface.
+				Default is false.
+		*/
+		void setIncremental(bool incremental) { incremental_ = incremental; }
+
+		///
+		bool isIncremental() const { return incremental_; }
+
+		/** Set the maximal fraction of spheres that may have changed for an incremental update.
+				If more spheres have changed, the whole surface is recomputed. Default is 0.25.
+		*/
+		void setMaximalIncrementalFraction(double fraction) { max_incremental_fraction_ = fraction; }
+
+		///
+		double getMaximalIncrementalFraction() const { return max_incremental_fraction_; }
+
+		/// Returns true if the last call of finish() updated the surface incrementally.
+		bool wasUpdatedIncrementally() const { return updated_incrementally_; }
+
+		/** Set the edge length (in Angstrom) of the blocks used for the spatial decomposition.
+				A value of 0 disables the decomposition. Default is 0.
+		*/
+		void setBlockSize(double block_size) { block_size_ = block_size; }
+
+		///
+		double getBlockSize() const { return block_size_; }
+
+		/// Returns true if the last call of finish() stitched the surface from several blocks.
+		bool wasDecomposed() const { return decomposed_; }
+
+		/** Returns the index of the sphere each triangle of the surface belongs to.
+				This is only available if incremental updates are enabled.
+		*/
+		const std::vector<Position>& getTriangleOwners() const { return triangle_owners_; }
+		//@}
+
+		/** @name Predicates.
+		*/
+		//@{
+
+		/// Returns true if every edge of the surface is shared by exactly two triangles.
+		static bool isClosed(const Surface& surface);
 		//@}
 
 		protected:
 
+		/** Compute the surface of the given spheres with the current settings.
+				@return false if the surface could not be computed
+		*/
+		bool computeSurface_(const std::vector<TSphere3<double> >& spheres, Surface& surface);
+
+		/** Compute the surface of the given spheres without changing the settings of the processor.
+				@param probe_radius the probe radius to start with; contains the one that was used afterwards
+				@return false if the surface could not be computed
+		*/
+		bool computeSurface_(const std::vector<TSphere3<double> >& spheres, Surface& surface, double& probe_radius) const;
+
+		/** Assign each triangle of the surface to the sphere with the smallest power distance
+				to the triangle's center.
+		*/
+		void computeTriangleOwners_(const Surface& surface, const std::vector<TSphere3<double> >& spheres,
+		                            std::vector<Position>& owners) const;
+
+		/** Append all triangles of source whose owner is selected to target, together with their vertices.
+				@param owner_map maps the owners of source to the owners stored in target_owners
+		*/
+		static void appendTriangles_(const Surface& source, const std::vector<Position>& source_owners,
+		                             const std::vector<Position>& owner_map, const std::vector<bool>& selected,
+		                             Surface& target, std::vector<Position>& target_owners);
+
+		/** Compute the surface of the given spheres block by block.
+				@return false if the surface could not be computed
+		*/
+		bool computeDecomposedSurface_(const std::vector<TSphere3<double> >& spheres, Surface& surface,
+		                               std::vector<Position>& owners);
+
+		/** Merge all vertices that lie within the given tolerance of each other and remove
+				triangles that become degenerate.
+		*/
+		static void mergeVertices_(Surface& surface, std::vector<Position>& owners, double tolerance);
+
+		/** Repair the seams of a surface merged from separately computed patches.
+				All triangles contained twice are removed. Around each edge that is not shared by
+				exactly two triangles, the triangles within two edge lengths are cut out, and the
+				holes left behind are closed by ear clipping.
+				@param max_edge_length the maximal length of the edges inserted into a hole
+				@return false if a hole is not bounded by a simple loop, does not form a disc on the
+								surface, or cannot be closed with edges of at most max_edge_length
+		*/
+		static bool stitchSeams_(Surface& surface, std::vector<Position>& owners, double max_edge_length);
+
+		/** Recompute the surface in the influence region of the given changed spheres.
+				@return false if an incremental update was not possible or the patched surface is not closed
+		*/
+		bool updateSurface_(const std::vector<Position>& changed);
+
+		//_ A block of the spatial decomposition.
+		struct Block_
+		{
+			//_ the spheres of the block first, followed by the surrounding ones
+			std::vector<TSphere3<double> > spheres;
+			//_ the indices of spheres in the whole structure
+			std::vector<Position> local_to_global;
+			//_ the number of the block's own spheres
+			Size number_of_core_spheres;
+			//_ the triangles belonging to the block's own spheres
+			Surface patch;
+			//_ the (global) owners of the triangles of patch
+			std::vector<Position> owners;
+			//_ the probe radius the surface of the block was computed with
+			double probe_radius;
+			//_ false if the surface of the block could not be computed with the given probe radius
+			bool ok;
+		};
+
+		//_ the number of attempts to compute all blocks with the same probe radius
+		static const Size MAX_BLOCK_ATTEMPTS;
+
+		/*_ Compute the patches of the blocks with the given probe radius.
+				Stops at the first block whose surface needs a different probe radius.
+		*/
+		void computeBlocks_(std::vector<Block_>& blocks, double probe_radius) const;
+
 		///
 		double													radius_offset_;
 
@@ -149,6 +298,32 @@ namespace BALL
 
 		//_
 		double													probe_radius_;
+
+		//_
+		bool														incremental_;
+
+		//_
+		double													max_incremental_fraction_;
+
+		//_
+		bool														updated_incrementally_;
+
+		//_ the spheres of the last computation
+		std::vector<TSphere3<double> >	previous_spheres_;
+
+		//_ settings of the last computation
+		double													previous_probe_radius_;
+		double													previous_density_;
+		SurfaceType											previous_type_;
+
+		//_ edge length of the blocks of the spatial decomposition, 0 if disabled
+		double													block_size_;
+
+		//_
+		bool														decomposed_;
+
+		//_ the sphere each triangle of surface_ belongs to
+		std::vector<Position>						triangle_owners_;
 	};
 
 }
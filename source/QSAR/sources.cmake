@@ -30,6 +30,7 @@ SET(SOURCES_LIST
 	regressionModel.C
 	regressionValidation.C
 	ringPerceptionProcessor.C
+	ringSet.C
 	simpleBase.C
 	simpleDescriptors.C
 	snBModel.C
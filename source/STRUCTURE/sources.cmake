@@ -7,9 +7,11 @@ SET(SOURCES_LIST
 	assignBondOrderProcessor.C
 	atomBijection.C
 	atomTyper.C
+	binaryFingerprintIndex.C
 	binaryFingerprintMethods.C
 	bindingPocketProcessor.C
 	buildBondsProcessor.C
+	canonicalHash.C
 	connectedComponentsProcessor.C
 	connolly.C
 	defaultProcessors.C
@@ -51,6 +53,8 @@ SET(SOURCES_LIST
 	SESFace.C
 	SESVertex.C
 	secondaryStructureProcessor.C
+	secondaryStructureTimeline.C
+	sideChainPacker.C
 	sideChainPlacementProcessor.C
 	smilesParser.C
 	smartsParser.C
@@ -113,6 +113,7 @@ SET(BALL_DOCKING_TESTS
 	GeneticAlgorithm_test
 	GeneticIndividual_test
 	GridAnalysis_test
+	LigandPreparationPipeline_test
 	Parameter_test
 	PoseClustering_test
 	Receptor_test
@@ -223,6 +224,7 @@ SET(BALL_MOLMEC_TESTS
 	SnapShotManager_test
 	ForceField_test
 	AmberFF_test
+	GAFFTypeProcessor_test
 	MMFF94_test
 	CharmmFF_test
 	EnergyMinimizer_test
@@ -293,6 +295,7 @@ SET(BALL_STRUCTURE_TESTS
 	AnalyticalSES_test
 	AssignBondOrderProcessor_test
 	AtomBijection_test
+	BinaryFingerprintIndex_test
 	BinaryFingerprintMethods_test
 	BindingPocketProcessor_test
 	ConnectedComponentsProcessor_test
@@ -300,6 +303,7 @@ SET(BALL_STRUCTURE_TESTS
 	Enumerator_test
 	EnumeratorIndex_test
 	GeometricProperties_test
+	Kekuliser_test
 	SimpleMolecularGraph_test
 	NumericalSAS_test
 	PeptideBuilder_test
@@ -313,6 +317,7 @@ SET(BALL_STRUCTURE_TESTS
 	ResidueChecker_test
 	RMSDMinimizer_test
 	SideChainPlacementProcessor_test
+	SideChainPacker_test
 	SmilesParser_test
 	SmartsParser_test
 	SmartsMatcher_test
@@ -321,7 +326,11 @@ SET(BALL_STRUCTURE_TESTS
 	TranslationProcessor_test
 	SurfaceProcessor_test
 	SecondaryStructureProcessor_test
+	SecondaryStructureTimeline_test
 	UCK_test
+	CanonicalHash_test
+	MolecularSimilarity_test
+	RingTemplateCache_test
 	BuildBondsProcessor_test
 #	MoleculeAssembler_test
 #	SDGenerator_test
@@ -361,6 +370,7 @@ SET(BALL_QSAR_TESTS
 	PartialChargeBase_test
 	PartialChargeDescriptors_test
 	RingPerceptionProcessor_test
+	RingSet_test
 	SimpleBase_test
 	SimpleDescriptors_test
 	SurfaceBase_test